@@ -6,7 +6,6 @@
 std::FILE			* IDebugLog::logFile = NULL;
 char				IDebugLog::sourceBuf[16] = { 0 };
 char				IDebugLog::headerText[16] = { 0 };
-char				IDebugLog::formatBuf[8192] = { 0 };
 int					IDebugLog::indentLevel = 0;
 int					IDebugLog::rightMargin = 0;
 int					IDebugLog::cursorPos = 0;
@@ -15,6 +14,181 @@ bool				IDebugLog::autoFlush = true;
 IDebugLog::LogLevel	IDebugLog::logLevel = IDebugLog::kLevel_DebugMessage;
 IDebugLog::LogLevel	IDebugLog::printLevel = IDebugLog::kLevel_Message;
 
+static const UInt32	kFormatBufSize = 8192;
+
+/**
+ *	Text of the line being built on the current thread, handed to Write as a whole
+ */
+struct LogLineBuffer
+{
+	enum { kSize = kFormatBufSize + 0x100 };
+
+	char	data[kSize];
+	UInt32	length;
+};
+
+static thread_local LogLineBuffer	s_lineBuf;
+
+/**
+ *	Multi-producer, single-consumer byte ring the async log is written through
+ *	
+ *	Producers reserve space for a record with a CAS on the write position, copy
+ *	their text in and publish the record by setting its header last. The writer
+ *	thread takes records in reservation order and zeroes them behind it, so an
+ *	unpublished header always reads as 0.
+ */
+namespace LogRing
+{
+	enum
+	{
+		kSize =			0x100000,	// power of 2, so positions may wrap around 2^32
+		kHeaderSize =	4,
+		kPublished =	0x80000000,
+	};
+
+	__declspec(align(64)) static char	buffer[kSize];
+	static volatile LONG	writePos = 0;		// reserved up to
+	static volatile LONG	readPos = 0;		// consumed up to
+	static volatile LONG	drainLock = 0;
+	static volatile DWORD	drainOwner = 0;		// id of the thread holding drainLock
+	static volatile LONG	writerWaiting = 0;
+	static volatile bool	running = false;
+	static HANDLE			wakeEvent = NULL;
+	static HANDLE			writerThread = NULL;
+	static LPTOP_LEVEL_EXCEPTION_FILTER	prevFaultFilter = NULL;
+	static bool				faultFilterSet = false;
+
+	static UInt32 RecordSize(UInt32 length)
+	{
+		return (kHeaderSize + length + 3) & ~3;
+	}
+
+	static void CopyIn(UInt32 pos, const char * src, UInt32 length)
+	{
+		UInt32	offset = pos & (kSize - 1);
+		UInt32	firstPart = (length < kSize - offset) ? length : (kSize - offset);
+		memcpy(buffer + offset, src, firstPart);
+		memcpy(buffer, src + firstPart, length - firstPart);
+	}
+
+	/**
+	 *	Writes out and releases the published records, returns the number written
+	 *	
+	 *	@param force wait for the drain if another thread holds it, taking it over only from
+	 *	a writer thread that has exited or from a drain interrupted on the calling thread
+	 */
+	static UInt32 Drain(FILE * file, bool force)
+	{
+		if(InterlockedExchange(&drainLock, 1))
+		{
+			if(!force)
+				return 0;
+			while(InterlockedExchange(&drainLock, 1))
+			{
+				// a live writer releases the lock after its batch, only one killed mid-drain (e.g. at process exit) never will
+				if(drainOwner == GetCurrentThreadId())
+					break;
+				if(writerThread && (WaitForSingleObject(writerThread, 0) == WAIT_OBJECT_0))
+					break;
+				Sleep(1);
+			}
+		}
+		drainOwner = GetCurrentThreadId();
+
+		UInt32	pos = readPos, numWritten = 0;
+		while(pos != (UInt32)writePos)
+		{
+			volatile UInt32	* header = (volatile UInt32 *)(buffer + (pos & (kSize - 1)));
+			UInt32	value = *header;
+			if(!(value & kPublished))
+				break;	// still being copied in, picked up on the next drain
+
+			UInt32	length = value & ~kPublished;
+			UInt32	size = RecordSize(length);
+			UInt32	offset = (pos + kHeaderSize) & (kSize - 1);
+			UInt32	firstPart = (length < kSize - offset) ? length : (kSize - offset);
+			if(file)
+			{
+				fwrite(buffer + offset, 1, firstPart, file);
+				fwrite(buffer, 1, length - firstPart, file);
+			}
+
+			offset = pos & (kSize - 1);
+			firstPart = (size < kSize - offset) ? size : (kSize - offset);
+			memset(buffer + offset, 0, firstPart);
+			memset(buffer, 0, size - firstPart);
+
+			pos += size;
+			InterlockedExchange(&readPos, pos);
+			numWritten++;
+		}
+
+		drainOwner = 0;
+		InterlockedExchange(&drainLock, 0);
+		return numWritten;
+	}
+
+	static void Push(const char * text, UInt32 length)
+	{
+		UInt32	size = RecordSize(length);
+		UInt32	pos;
+		while(true)
+		{
+			pos = writePos;
+			if(pos + size - (UInt32)readPos > kSize)
+			{
+				// full, let the writer catch up
+				SetEvent(wakeEvent);
+				Sleep(0);
+				continue;
+			}
+			if(InterlockedCompareExchange(&writePos, pos + size, pos) == pos)
+				break;
+		}
+
+		CopyIn(pos + kHeaderSize, text, length);
+		InterlockedExchange((volatile LONG *)(buffer + (pos & (kSize - 1))), kPublished | length);
+
+		if(writerWaiting && InterlockedExchange(&writerWaiting, 0))
+			SetEvent(wakeEvent);
+	}
+
+	static DWORD WINAPI WriterThread(LPVOID file)
+	{
+		while(running)
+		{
+			if(Drain((FILE *)file, false))
+			{
+				fflush((FILE *)file);
+				continue;
+			}
+
+			InterlockedExchange(&writerWaiting, 1);
+
+			// a record published after the drain above is either seen here or has its producer set the event
+			WaitForSingleObject(wakeEvent, (readPos == writePos) ? 100 : 1);
+		}
+
+		return 0;
+	}
+
+	/**
+	 *	Writes out the ring when the process crashes, the lines logged just before a crash being the ones that matter
+	 *	
+	 *	Installed as the unhandled exception filter, so faults caught by a __try never reach it,
+	 *	then hands the exception to whichever filter was there before.
+	 */
+	static LONG WINAPI FaultFilter(PEXCEPTION_POINTERS info)
+	{
+		IDebugLog::Flush();
+
+		if(prevFaultFilter)
+			return prevFaultFilter(info);
+
+		return EXCEPTION_CONTINUE_SEARCH;
+	}
+}
+
 IDebugLog::IDebugLog()
 {
 	//
@@ -27,6 +201,8 @@ IDebugLog::IDebugLog(const char * name)
 
 IDebugLog::~IDebugLog()
 {
+	SetAsync(false);
+
 	if(logFile)
 		fclose(logFile);
 }
@@ -100,6 +276,7 @@ void IDebugLog::Message(const char * message, const char * source)
 void IDebugLog::FormattedMessage(const char * fmt, ...)
 {
 	va_list	argList;
+	char	formatBuf[kFormatBufSize];
 
 	va_start(argList, fmt);
 	vsprintf_s(formatBuf, sizeof(formatBuf), fmt, argList);
@@ -115,6 +292,8 @@ void IDebugLog::FormattedMessage(const char * fmt, ...)
  */
 void IDebugLog::FormattedMessage(const char * fmt, va_list args)
 {
+	char	formatBuf[kFormatBufSize];
+
 	vsprintf_s(formatBuf, sizeof(formatBuf), fmt, args);
 	Message(formatBuf);
 }
@@ -123,6 +302,7 @@ void IDebugLog::Log(LogLevel level, const char * fmt, va_list args)
 {
 	bool	log = (level <= logLevel);
 	bool	print = (level <= printLevel);
+	char	formatBuf[kFormatBufSize];
 
 	if(log || print)
 		vsprintf_s(formatBuf, sizeof(formatBuf), fmt, args);
@@ -132,6 +312,10 @@ void IDebugLog::Log(LogLevel level, const char * fmt, va_list args)
 	
 	if(print)
 		printf("%s\n", formatBuf);
+
+	// the process is likely about to go down, get everything to disk now
+	if(level == kLevel_FatalError)
+		Flush();
 }
 
 /**
@@ -182,6 +366,7 @@ void IDebugLog::OpenBlock(void)
 	SeekCursor(indentLevel * 4);
 
 	PrintText(headerText);
+	WriteLine();
 
 	inBlock = 1;
 }
@@ -204,6 +389,79 @@ void IDebugLog::SetAutoFlush(bool inAutoFlush)
 	autoFlush = inAutoFlush;
 }
 
+/**
+ *	Enable/disable writing the log from a background thread
+ *	
+ *	When enabled, logging threads only copy their lines into a ring buffer and
+ *	never wait on disk I/O; lines are written in the order they were logged.
+ *	When disabled, each line is written out by the logging thread before it
+ *	returns, as in the original behaviour.
+ *	
+ *	@param inAsync async state
+ */
+void IDebugLog::SetAsync(bool inAsync)
+{
+	if(inAsync == LogRing::running)
+		return;
+
+	if(inAsync)
+	{
+		if(!logFile)
+			return;
+
+		if(!LogRing::wakeEvent)
+			LogRing::wakeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+		LogRing::running = true;
+		LogRing::writerThread = CreateThread(NULL, 0, LogRing::WriterThread, logFile, 0, NULL);
+		if(!LogRing::writerThread)
+		{
+			LogRing::running = false;
+			return;
+		}
+
+		LogRing::prevFaultFilter = SetUnhandledExceptionFilter(LogRing::FaultFilter);
+		LogRing::faultFilterSet = true;
+	}
+	else
+	{
+		if(LogRing::faultFilterSet)
+		{
+			// a filter installed after ours chains to it, leave that one in place
+			LPTOP_LEVEL_EXCEPTION_FILTER current = SetUnhandledExceptionFilter(LogRing::prevFaultFilter);
+			if(current != LogRing::FaultFilter)
+				SetUnhandledExceptionFilter(current);
+			LogRing::faultFilterSet = false;
+		}
+
+		LogRing::running = false;
+		SetEvent(LogRing::wakeEvent);
+
+		// bounded, as this can run from DLL detach where the thread may be unable to exit
+		WaitForSingleObject(LogRing::writerThread, 1000);
+
+		// while the handle is still open, so a writer killed mid-drain can be told apart from a slow one
+		Flush();
+
+		CloseHandle(LogRing::writerThread);
+		LogRing::writerThread = NULL;
+	}
+}
+
+/**
+ *	Writes out everything logged so far, on the calling thread
+ *	
+ *	Waits for a drain in progress on the writer thread, or takes it over if that thread is gone.
+ */
+void IDebugLog::Flush(void)
+{
+	if(!logFile)
+		return;
+
+	LogRing::Drain(logFile, true);
+	fflush(logFile);
+}
+
 /**
  *	Print spaces to the log
  *	
@@ -217,15 +475,18 @@ void IDebugLog::PrintSpaces(int numSpaces)
 	{
 		while(numSpaces > 0)
 		{
+			if(s_lineBuf.length == LogLineBuffer::kSize)
+				WriteLine();
+
 			if(numSpaces >= TabSize())
 			{
 				numSpaces -= TabSize();
-				fputc('\t', logFile);
+				s_lineBuf.data[s_lineBuf.length++] = '\t';
 			}
 			else
 			{
 				numSpaces--;
-				fputc(' ', logFile);
+				s_lineBuf.data[s_lineBuf.length++] = ' ';
 			}
 		}
 	}
@@ -234,17 +495,10 @@ void IDebugLog::PrintSpaces(int numSpaces)
 }
 
 /**
- *	Prints raw text to the log file
+ *	Adds raw text to the current line
  */
 void IDebugLog::PrintText(const char * buf)
 {
-	if(logFile)
-	{
-		fputs(buf, logFile);
-		if(autoFlush)
-			fflush(logFile);
-	}
-
 	const char	* traverse = buf;
 	char		data;
 
@@ -255,24 +509,74 @@ void IDebugLog::PrintText(const char * buf)
 		else
 			cursorPos++;
 	}
+
+	if(logFile)
+	{
+		UInt32	length = traverse - buf - 1;
+		while(length)
+		{
+			if(s_lineBuf.length == LogLineBuffer::kSize)
+				WriteLine();
+
+			UInt32	part = LogLineBuffer::kSize - s_lineBuf.length;
+			if(part > length)
+				part = length;
+			memcpy(s_lineBuf.data + s_lineBuf.length, buf, part);
+			s_lineBuf.length += part;
+			buf += part;
+			length -= part;
+		}
+	}
 }
 
 /**
- *	Moves to the next line of the log file
+ *	Ends the current line and writes it to the log file
  */
 void IDebugLog::NewLine(void)
 {
 	if(logFile)
 	{
-		fputc('\n', logFile);
+		if(s_lineBuf.length == LogLineBuffer::kSize)
+			WriteLine();
 
-		if(autoFlush)
-			fflush(logFile);
+		s_lineBuf.data[s_lineBuf.length++] = '\n';
+		WriteLine();
 	}
 
 	cursorPos = 0;
 }
 
+/**
+ *	Writes out the text built up on the current thread
+ */
+void IDebugLog::WriteLine(void)
+{
+	if(s_lineBuf.length)
+	{
+		Write(s_lineBuf.data, s_lineBuf.length);
+		s_lineBuf.length = 0;
+	}
+}
+
+/**
+ *	Writes text to the log file, directly or through the writer thread
+ */
+void IDebugLog::Write(const char * text, UInt32 length)
+{
+	if(!logFile)
+		return;
+
+	if(LogRing::running)
+	{
+		LogRing::Push(text, length);
+		return;
+	}
+
+	fwrite(text, 1, length, logFile);
+	if(autoFlush)
+		fflush(logFile);
+}
+
 /**
  *	Prints spaces to align the cursor to the requested position
  *	
@@ -45,6 +45,9 @@ class IDebugLog
 
 		static void			SetAutoFlush(bool inAutoFlush);
 
+		static void			SetAsync(bool inAsync);
+		static void			Flush(void);
+
 		static void			SetLogLevel(LogLevel in)	{ logLevel = in; }
 		static void			SetPrintLevel(LogLevel in)	{ printLevel = in; }
 
@@ -52,6 +55,8 @@ class IDebugLog
 		static void			PrintSpaces(int numSpaces);
 		static void			PrintText(const char * buf);
 		static void			NewLine(void);
+		static void			WriteLine(void);
+		static void			Write(const char * text, UInt32 length);
 
 		static void			SeekCursor(int position);
 
@@ -62,7 +67,6 @@ class IDebugLog
 
 		static char			sourceBuf[16];		//!< name of current source, used in prefix
 		static char			headerText[16];		//!< current text to use as line prefix
-		static char			formatBuf[8192];	//!< temp buffer used for formatted messages
 
 		static int			indentLevel;		//!< the current indentation level (in tabs)
 		static int			rightMargin;		//!< the column at which text should be wrapped
@@ -171,8 +171,10 @@ std::string ArrayElement::GetStringRepresentation() const
 	case kDataType_Numeric:
 	{
 		double numeric;
+		char numBuf[0x20];
 		this->GetAsNumber(&numeric);
-		return FormatString("%g", numeric);
+		NumToStr(numBuf, numeric);
+		return numBuf;
 	}
 	case kDataType_Form:
 	{
@@ -1060,6 +1062,29 @@ bool ArrayVar::GetNextElement(const ArrayKey* prevKey, ArrayElement** outElem, c
 	return false;
 }
 
+bool ArrayVar::GetNextElement(const ArrayKey* prevKey, UInt32& index, ArrayElement** outElem, const ArrayKey** outKey)
+{
+	if (!prevKey || Empty())
+		return false;
+
+	// arrays are keyed by position, for maps the element at the cursor must still be the one with prevKey
+	ArrayIterator iter = m_elements.seek(index);
+	if (iter.End() || !(*iter.first() == *prevKey))
+	{
+		iter = m_elements.find(prevKey);
+		if (iter.End())
+			return false;
+		index = iter.index();
+	}
+	++iter;
+	++index;
+	if (iter.End())
+		return false;
+	*outKey = iter.first();
+	*outElem = iter.second();
+	return true;
+}
+
 bool ArrayVar::GetPrevElement(const ArrayKey* prevKey, ArrayElement** outElem, const ArrayKey** outKey)
 {
 	if (!prevKey || Empty())
@@ -1122,6 +1147,25 @@ bool ArrayVar::SetSize(UInt32 newSize, const ArrayElement* padWith)
 	return true;
 }
 
+bool ArrayVar::AppendStrings(const char *src, const TokenSpan *spans, UInt32 count)
+{
+	if (!m_bPacked)
+		return false;
+	auto* pArray = m_elements.getArrayPtr();
+	pArray->Reserve(pArray->Size() + count);
+	for (const TokenSpan *span = spans, *end = spans + count; span != end; ++span)
+	{
+		char *str = (char*)malloc(span->length + 1);
+		memcpy(str, src + span->offset, span->length);
+		str[span->length] = 0;
+		ArrayElement* elem = pArray->Append();
+		elem->m_data.dataType = kDataType_String;
+		elem->m_data.owningArray = m_ID;
+		elem->m_data.str = str;
+	}
+	return true;
+}
+
 bool ArrayVar::Insert(UInt32 atIndex, const ArrayElement* toInsert)
 {
 	if (!m_bPacked)
@@ -1709,7 +1753,6 @@ ArrayVar* ArrayVarMap::Add(UInt32 varID, UInt32 keyType, bool packed, UInt8 modI
 {
 	ArrayVar* var = VarMap::Insert(varID, keyType, packed, modIndex);
 	ScopedLock lock(var->m_cs);
-	availableIDs.Erase(varID);
 	var->m_ID = varID;
 	if (numRefs) // record references to this array
 		var->m_refs.Concatenate(refs, numRefs);
@@ -1787,83 +1830,235 @@ ArrayElement* ArrayVarMap::GetElement(ArrayID id, const ArrayKey* key)
 	return arr ? arr->Get(key, false) : nullptr;
 }
 
-void ArrayVarMap::Save(NVSESerializationInterface* intfc)
+void ArrayVarMap::EncodeVar(ArrayVar* pVar, Serialization::RecordBuffer& buffer, UInt32& numBadElems)
 {
-	Clean();
+	const UInt8 keyType = pVar->m_keyType;
+	UInt32 numRefs = pVar->m_refs.Size();
+	buffer.Write8(pVar->m_owningModIndex);
+	buffer.Write32(pVar->m_ID);
+	buffer.Write8(keyType);
+	buffer.Write8(pVar->m_bPacked);
+	buffer.Write32(numRefs);
+	buffer.WriteN(pVar->m_refs.Data(), numRefs);
 
-	Serialization::OpenRecord('ARVS', kVersion);
+	const UInt32 numElements = pVar->Size();
+	buffer.Write32(numElements);
+	if (!numElements) return;
 
-	ArrayVar* pVar;
-	UInt32 numRefs;
-	UInt8 keyType;
 	const ArrayKey* pKey;
 	const ArrayElement* pElem;
 	char* str;
 	UInt16 len;
+	for (ArrayIterator elems = pVar->m_elements.begin(); !elems.End(); ++elems)
+	{
+		pKey = elems.first();
+		pElem = elems.second();
+
+		if (keyType == kDataType_String)
+		{
+			str = pKey->key.str;
+			len = StrLen(str);
+			buffer.Write16(len);
+			buffer.WriteBuf(str, len);
+		}
+		else if (!pVar->m_bPacked)
+			buffer.Write64(&pKey->key.num);
+
+		buffer.Write8(pElem->m_data.dataType);
+		switch (pElem->m_data.dataType)
+		{
+		case kDataType_Numeric:
+			buffer.Write64(&pElem->m_data.num);
+			break;
+		case kDataType_String:
+			{
+				str = pElem->m_data.str;
+				len = StrLen(str);
+				buffer.Write16(len);
+				buffer.WriteBuf(str, len);
+				break;
+			}
+		case kDataType_Array:
+		case kDataType_Form:
+			buffer.Write32(pElem->m_data.formID);
+			break;
+		default:
+			numBadElems++;
+			break;
+		}
+	}
+}
+
+void ArrayVarMap::Save(NVSESerializationInterface* intfc)
+{
+	Clean();
+
+	Serialization::OpenRecord('ARVS', kVersion);
+
+	// gather the arrays to save in map order so the output matches a plain serial walk over vars
+	std::vector<ArrayVar*> toSave;
+	toSave.reserve(vars.Size());
+	UInt32 totalWork = 0;
 	for (auto iter = vars.Begin(); !iter.End(); ++iter)
 	{
 		if (IsTemporary(iter.Key()))
 			continue;
+		ArrayVar* pVar = &iter.Get();
+		if (pVar->m_refs.Empty())
+			continue;
+		toSave.push_back(pVar);
+		totalWork += pVar->Size() + 1;
+	}
 
-		pVar = &iter.Get();
-		numRefs = pVar->m_refs.Size();
-		if (!numRefs) continue;
-		keyType = pVar->m_keyType;
+	// split into contiguous shards of roughly equal element counts and encode each into its own buffer
+	struct Shard
+	{
+		UInt32 begin = 0, end = 0;
+		Serialization::RecordBuffer buffer;
+		std::vector<UInt32> recordEnds;
+		UInt32 numBadElems = 0;
+	};
+	const UInt32 numShards = Serialization::GetNumWorkShards(totalWork);
+	std::vector<Shard> shards(numShards);
+	{
+		const UInt32 workPerShard = totalWork / numShards + 1;
+		UInt32 shardIdx = 0, shardWork = 0;
+		for (UInt32 i = 0; i < toSave.size(); i++)
+		{
+			shardWork += toSave[i]->Size() + 1;
+			if (shardWork >= workPerShard && shardIdx + 1 < numShards)
+			{
+				shards[shardIdx].end = i + 1;
+				shards[++shardIdx].begin = i + 1;
+				shardWork = 0;
+			}
+		}
+		shards[shardIdx].end = toSave.size();
+		while (++shardIdx < numShards)
+			shards[shardIdx].begin = shards[shardIdx].end = toSave.size();
+	}
+
+	Serialization::RunWorkShards(numShards, [&](UInt32 shardIdx)
+	{
+		Shard& shard = shards[shardIdx];
+		shard.recordEnds.reserve(shard.end - shard.begin);
+		for (UInt32 i = shard.begin; i < shard.end; i++)
+		{
+			EncodeVar(toSave[i], shard.buffer, shard.numBadElems);
+			shard.recordEnds.push_back(shard.buffer.Size());
+		}
+	});
 
-		Serialization::OpenRecord('ARVR', kVersion);
-		Serialization::WriteRecord8(pVar->m_owningModIndex);
-		Serialization::WriteRecord32(iter.Key());
-		Serialization::WriteRecord8(keyType);
-		Serialization::WriteRecord8(pVar->m_bPacked);
-		Serialization::WriteRecord32(numRefs);
-		Serialization::WriteRecordData(pVar->m_refs.Data(), numRefs);
+	// emit the records serially, in the order they were gathered
+	for (const Shard& shard : shards)
+	{
+		Serialization::WriteRecordBatch('ARVR', kVersion, shard.buffer, shard.recordEnds.data(), shard.recordEnds.size());
+		if (shard.numBadElems)
+			_MESSAGE("Error in ArrayVarMap::Save() - %d elements of unhandled type not saved.", shard.numBadElems);
+	}
 
-		numRefs = pVar->Size();
-		Serialization::WriteRecord32(numRefs);
-		if (!numRefs) continue;
+	Serialization::OpenRecord('ARVE', kVersion);
+}
+UInt32 ArrayVarMap::DecodeElements(ArrayVar* newArr, Serialization::RecordReader& reader, UInt32 numElements,
+                                   UInt32 version, char* keyBuffer)
+{
+	const UInt8 keyType = newArr->m_keyType;
+	const bool bPacked = newArr->m_bPacked;
+	const ArrayID arrayID = newArr->m_ID;
+	const ContainerType contType = newArr->GetContainerType();
 
-		for (ArrayIterator elems = pVar->m_elements.begin(); !elems.End(); ++elems)
+	ArrayElement *elements = nullptr, *elem;
+	ElementNumMap* pNumMap = nullptr;
+	ElementStrMap* pStrMap = nullptr;
+	switch (contType)
+	{
+	case kContainer_Array:
 		{
-			pKey = elems.first();
-			pElem = elems.second();
+			auto* pArray = newArr->m_elements.getArrayPtr();
+			pArray->Resize(numElements);
+			elements = pArray->Data();
+			break;
+		}
+	case kContainer_NumericMap:
+		pNumMap = newArr->m_elements.getNumMapPtr();
+		pNumMap->Reserve(numElements);
+		break;
+	case kContainer_StringMap:
+		pStrMap = newArr->m_elements.getStrMapPtr();
+		pStrMap->Reserve(numElements);
+		break;
+	default:
+		return 0;
+	}
 
-			if (keyType == kDataType_String)
-			{
-				str = pKey->key.str;
-				len = StrLen(str);
-				Serialization::WriteRecord16(len);
-				if (len) Serialization::WriteRecordData(str, len);
-			}
-			else if (!pVar->m_bPacked)
-				Serialization::WriteRecord64(&pKey->key.num);
+	UInt32 numBadElems = 0;
+	UInt16 strLength;
+	double numKey;
+	for (UInt32 i = 0; i < numElements; i++)
+	{
+		if (keyType == kDataType_String)
+		{
+			strLength = reader.Read16();
+			keyBuffer[reader.ReadBuf(keyBuffer, strLength)] = 0;
+		}
+		else if (!bPacked || (version < 2))
+			reader.Read64(&numKey);
+
+		UInt8 elemType = reader.Read8();
+
+		switch (contType)
+		{
+		default:
+		case kContainer_Array:
+			elem = &elements[i];
+			break;
+		case kContainer_NumericMap:
+			elem = &(*pNumMap)[numKey];
+			break;
+		case kContainer_StringMap:
+			elem = &(*pStrMap)[keyBuffer];
+			break;
+		}
+
+		elem->m_data.dataType = (DataType)elemType;
+		elem->m_data.owningArray = arrayID;
 
-			Serialization::WriteRecord8(pElem->m_data.dataType);
-			switch (pElem->m_data.dataType)
+		switch (elemType)
+		{
+		case kDataType_Numeric:
+			reader.Read64(&elem->m_data.num);
+			break;
+		case kDataType_String:
 			{
-			case kDataType_Numeric:
-				Serialization::WriteRecord64(&pElem->m_data.num);
-				break;
-			case kDataType_String:
+				strLength = reader.Read16();
+				if (strLength)
 				{
-					str = pElem->m_data.str;
-					len = StrLen(str);
-					Serialization::WriteRecord16(len);
-					if (len) Serialization::WriteRecordData(str, len);
-					break;
+					char* strVal = (char*)malloc(strLength + 1);
+					strVal[reader.ReadBuf(strVal, strLength)] = 0;
+					elem->m_data.str = strVal;
 				}
-			case kDataType_Array:
-			case kDataType_Form:
-				Serialization::WriteRecord32(pElem->m_data.formID);
+				else elem->m_data.str = nullptr;
+				break;
+			}
+		case kDataType_Array:
+			elem->m_data.arrID = reader.Read32();
+			break;
+		case kDataType_Form:
+			{
+				UInt32 formID = reader.Read32();
+				if (!Serialization::ResolveRefID(formID, &formID))
+					formID = 0;
+				elem->m_data.formID = formID;
 				break;
-			default:
-				_MESSAGE("Error in ArrayVarMap::Save() - unhandled element type %d. Element not saved.",
-				         pElem->m_data.dataType);
 			}
+		default:
+			numBadElems++;
+			break;
 		}
 	}
-
-	Serialization::OpenRecord('ARVE', kVersion);
+	return numBadElems;
 }
+
 #if _DEBUG
 std::set<std::string> g_modsWithCosaveVars;
 #endif
@@ -1874,17 +2069,24 @@ void ArrayVarMap::Load(NVSESerializationInterface* intfc)
 	Clean(); // clean up any vars queued for garbage collection
 
 	UInt32 type, length, version, arrayID, tempRefID, numElements;
-	UInt16 strLength;
 	UInt8 modIndex, keyType;
 	bool bPacked;
-	ContainerType contType;
 	static UInt8 buffer[kMaxMessageLength];
 
+	// elements are decoded after all records have been indexed, see below
+	struct PendingElements
+	{
+		ArrayVar* arr;
+		Serialization::RecordReader reader;
+		UInt32 numElements;
+		UInt32 version;
+	};
+	std::vector<PendingElements> pending;
+	UInt32 totalElements = 0;
+
 	//Reset(intfc);
 	bool bContinue = true;
-	UInt32 lastIndexRead = 0;
 
-	double numKey;
 	std::unordered_map<UInt8, UInt32> varCountMap;
 	while (bContinue && Serialization::GetNextRecordInfo(&type, &version, &length))
 	{
@@ -1895,7 +2097,9 @@ void ArrayVarMap::Load(NVSESerializationInterface* intfc)
 			break;
 		case 'ARVR':
 			{
-				modIndex = Serialization::ReadRecord8();
+				Serialization::RecordReader reader(Serialization::ReadRecordDataPtr(&length), length);
+
+				modIndex = reader.Read8();
 #if _DEBUG
 				g_modsWithCosaveVars.insert(g_modsLoaded.at(modIndex));
 #endif
@@ -1912,9 +2116,9 @@ void ArrayVarMap::Load(NVSESerializationInterface* intfc)
 				else
 					modIndex = (tempRefID >> 24);
 
-				arrayID = Serialization::ReadRecord32();
-				keyType = Serialization::ReadRecord8();
-				bPacked = Serialization::ReadRecord8();
+				arrayID = reader.Read32();
+				keyType = reader.Read8();
+				bPacked = reader.Read8();
 
 				// read refs, fix up mod indexes, discard refs from unloaded mods
 				UInt32 numRefs = 0; // # of references to this array
@@ -1922,7 +2126,7 @@ void ArrayVarMap::Load(NVSESerializationInterface* intfc)
 				// reference-counting implemented in v1
 				if (version >= 1)
 				{
-					numRefs = Serialization::ReadRecord32();
+					numRefs = reader.Read32();
 					if (numRefs)
 					{
 						UInt32 tempRefID = 0;
@@ -1930,7 +2134,7 @@ void ArrayVarMap::Load(NVSESerializationInterface* intfc)
 						UInt32 refIdx = 0;
 						for (UInt32 i = 0; i < numRefs; i++)
 						{
-							curModIndex = Serialization::ReadRecord8();
+							curModIndex = reader.Read8();
 							if (curModIndex == 0xFF)
 								continue;
 #if _DEBUG
@@ -1980,110 +2184,21 @@ void ArrayVarMap::Load(NVSESerializationInterface* intfc)
 					continue;
 				}
 
-				// record gaps between IDs for easy lookup later in GetUnusedID()
-				lastIndexRead++;
-				while (lastIndexRead < arrayID)
+				if (!IsValidID(arrayID))
 				{
-					SetIDAvailable(lastIndexRead);
-					lastIndexRead++;
+					_MESSAGE("Array ID %d is out of range, the cosave may be corrupt. Discarding", arrayID);
+					continue;
 				}
 
+				// gaps between loaded IDs need no bookkeeping, GetUnusedID() hands out the lowest unused ID
 				// create array and add to map
 				ArrayVar* newArr = Add(arrayID, keyType, bPacked, modIndex, numRefs, buffer);
 
-				// read the array elements
-				numElements = Serialization::ReadRecord32();
+				numElements = reader.Read32();
 				if (!numElements) continue;
 
-				contType = newArr->GetContainerType();
-
-				ArrayElement *elements, *elem;
-				ElementNumMap* pNumMap;
-				ElementStrMap* pStrMap;
-				switch (contType)
-				{
-				case kContainer_Array:
-					{
-						auto* pArray = newArr->m_elements.getArrayPtr();
-						pArray->Resize(numElements);
-						elements = pArray->Data();
-						break;
-					}
-				case kContainer_NumericMap:
-					pNumMap = newArr->m_elements.getNumMapPtr();
-					break;
-				case kContainer_StringMap:
-					pStrMap = newArr->m_elements.getStrMapPtr();
-					break;
-				default:
-					continue;
-				}
-
-				for (UInt32 i = 0; i < numElements; i++)
-				{
-					if (keyType == kDataType_String)
-					{
-						strLength = Serialization::ReadRecord16();
-						if (strLength) Serialization::ReadRecordData(buffer, strLength);
-						buffer[strLength] = 0;
-					}
-					else if (!bPacked || (version < 2))
-						Serialization::ReadRecord64(&numKey);
-
-					UInt8 elemType = Serialization::ReadRecord8();
-
-					switch (contType)
-					{
-					default:
-					case kContainer_Array:
-						elem = &elements[i];
-						break;
-					case kContainer_NumericMap:
-						elem = &(*pNumMap)[numKey];
-						break;
-					case kContainer_StringMap:
-						elem = &(*pStrMap)[(char*)buffer];
-						break;
-					}
-
-					elem->m_data.dataType = (DataType)elemType;
-					elem->m_data.owningArray = arrayID;
-
-					switch (elemType)
-					{
-					case kDataType_Numeric:
-						Serialization::ReadRecord64(&elem->m_data.num);
-						break;
-					case kDataType_String:
-						{
-							strLength = Serialization::ReadRecord16();
-							if (strLength)
-							{
-								char* strVal = (char*)malloc(strLength + 1);
-								Serialization::ReadRecordData(strVal, strLength);
-								strVal[strLength] = 0;
-								elem->m_data.str = strVal;
-							}
-							else elem->m_data.str = nullptr;
-							break;
-						}
-					case kDataType_Array:
-						elem->m_data.arrID = Serialization::ReadRecord32();
-						break;
-					case kDataType_Form:
-						{
-							UInt32 formID = Serialization::ReadRecord32();
-							if (!Serialization::ResolveRefID(formID, &formID))
-								formID = 0;
-							elem->m_data.formID = formID;
-							break;
-						}
-					default:
-						_MESSAGE("Unknown element type %d encountered while loading array var, element discarded.",
-						         elemType);
-						break;
-					}
-				}
+				pending.push_back({newArr, reader, numElements, version});
+				totalElements += numElements;
 				break;
 			}
 		default:
@@ -2091,6 +2206,43 @@ void ArrayVarMap::Load(NVSESerializationInterface* intfc)
 			break;
 		}
 	}
+
+	// every array now exists and owns its slice of the cosave buffer, so elements can be decoded concurrently;
+	// each array is only ever touched by one shard
+	const UInt32 numShards = Serialization::GetNumWorkShards(totalElements);
+	const UInt32 elementsPerShard = totalElements / numShards + 1;
+	std::vector<UInt32> shardStarts(numShards + 1, pending.size());
+	{
+		UInt32 shardIdx = 0, shardElements = 0;
+		shardStarts[0] = 0;
+		for (UInt32 i = 0; i < pending.size(); i++)
+		{
+			shardElements += pending[i].numElements;
+			if (shardElements >= elementsPerShard && shardIdx + 1 < numShards)
+			{
+				shardStarts[++shardIdx] = i + 1;
+				shardElements = 0;
+			}
+		}
+	}
+
+	std::vector<UInt32> badElemCounts(numShards);
+	Serialization::RunWorkShards(numShards, [&](UInt32 shardIdx)
+	{
+		const auto keyBuffer = std::make_unique<char[]>(0x10000);
+		for (UInt32 i = shardStarts[shardIdx]; i < shardStarts[shardIdx + 1]; i++)
+		{
+			PendingElements& toDecode = pending[i];
+			badElemCounts[shardIdx] += DecodeElements(toDecode.arr, toDecode.reader, toDecode.numElements,
+			                                          toDecode.version, keyBuffer.get());
+		}
+	});
+
+	for (const UInt32 numBadElems : badElemCounts)
+	{
+		if (numBadElems)
+			_MESSAGE("Unknown element type encountered %d times while loading array vars, elements discarded.", numBadElems);
+	}
 }
 
 void ArrayVarMap::Clean() // garbage collection: delete unreferenced arrays
@@ -280,6 +280,7 @@ public:
 		iterator(ContainerType type, const GenericIterator& iterator);
 
 		bool End() {return m_iter.index >= m_iter.contObj->numItems;}
+		UInt32 index() const {return m_iter.index;}
 
 		void operator++();
 		void operator--();
@@ -296,6 +297,8 @@ public:
 	iterator end() const;
 
 	iterator find(const ArrayKey* key) {return iterator(*this, key);}
+	// iterator to the element at a position, End() if past the last one
+	iterator seek(UInt32 index);
 
 	ElementVector* getArrayPtr() const {return &AsArray();}
 	ElementNumMap* getNumMapPtr() const {return &AsNumMap();}
@@ -386,6 +389,8 @@ public:
 	bool GetFirstElement(ArrayElement** outElem, const ArrayKey** outKey);
 	bool GetLastElement(ArrayElement** outElem, const ArrayKey** outKey);
 	bool GetNextElement(const ArrayKey* prevKey, ArrayElement** outElem, const ArrayKey** outKey);
+	// cursor variant: index holds the position of prevKey and is advanced, the key lookup is only done if it moved
+	bool GetNextElement(const ArrayKey* prevKey, UInt32& index, ArrayElement** outElem, const ArrayKey** outKey);
 	bool GetPrevElement(const ArrayKey* prevKey, ArrayElement** outElem, const ArrayKey** outKey);
 
 	UInt32 EraseElement(const ArrayKey* key);
@@ -395,6 +400,8 @@ public:
 	bool SetSize(UInt32 newSize, const ArrayElement* padWith);
 	bool Insert(UInt32 atIndex, const ArrayElement* toInsert);
 	bool Insert(UInt32 atIndex, ArrayID rangeID);
+	// appends the given spans of src as string elements of a packed array, sizing its storage once
+	bool AppendStrings(const char *src, const TokenSpan *spans, UInt32 count);
 
 	ArrayVar *GetKeys(UInt8 modIndex);
 	ArrayVar *Copy(UInt8 modIndex, bool bDeepCopy);
@@ -426,6 +433,12 @@ class ArrayVarMap : public VarMap<ArrayVar>
 	static const UInt32 kVersion = 2;
 
 	ArrayVar* Add(UInt32 varID, UInt32 keyType, bool packed, UInt8 modIndex, UInt32 numRefs, UInt8* refs);
+	// encodes the body of an ARVR record; safe to call concurrently for different arrays
+	static void EncodeVar(ArrayVar* pVar, Serialization::RecordBuffer& buffer, UInt32& numBadElems);
+	// decodes the elements of an ARVR record into a freshly added array, returns the number of unknown elements
+	// safe to call concurrently for different arrays
+	static UInt32 DecodeElements(ArrayVar* newArr, Serialization::RecordReader& reader, UInt32 numElements,
+	                             UInt32 version, char* keyBuffer);
 public:
 	void Save(NVSESerializationInterface* intfc);
 	void Load(NVSESerializationInterface* intfc);
@@ -269,6 +269,25 @@ ArrayElement* ArrayVarElementContainer::iterator::second()
 
 ArrayVarElementContainer::iterator ArrayVarElementContainer::begin(){return iterator(*this);}
 
+ArrayVarElementContainer::iterator ArrayVarElementContainer::seek(UInt32 index)
+{
+	iterator iter(*this);
+	switch (m_type)
+	{
+		default:
+		case kContainer_Array:
+			iter.AsArray().Find(AsArray(), index);
+			break;
+		case kContainer_NumericMap:
+			iter.AsNumMap().Seek(AsNumMap(), index);
+			break;
+		case kContainer_StringMap:
+			iter.AsStrMap().Seek(AsStrMap(), index);
+			break;
+	}
+	return iter;
+}
+
 ArrayVarElementContainer::iterator ArrayVarElementContainer::rbegin(){return iterator(*this, true);}
 
 ArrayVarElementContainer::iterator ArrayVarElementContainer::end() const
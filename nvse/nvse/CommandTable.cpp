@@ -1845,6 +1845,17 @@ void CommandTable::AddCommandsV6()
 	ADD_CMD(DumpEventHandlers);
 	ADD_CMD_RET(GetEventHandlers, kRetnType_Array);
 	ADD_CMD_RET(GetSelfAlt, kRetnType_Form);
+
+	// 6.2 beta 08
+	ADD_CMD(ClearUDFCache);
+	ADD_CMD_RET(GetUDFCacheStats, kRetnType_Array);
+	ADD_CMD(SetDeferredCallBudget);
+	ADD_CMD_RET(GetDeferredCallStats, kRetnType_Array);
+	ADD_CMD(CallWhileInterval);
+	ADD_CMD(CallWhenInterval);
+	ADD_CMD(SetRuntimeErrorRepeatLimit);
+	ADD_CMD_RET(GetRuntimeErrorStats, kRetnType_Array);
+	ADD_CMD(GetConsolePrintOverflowCount);
 }
 
 namespace PluginAPI
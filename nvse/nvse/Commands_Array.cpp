@@ -915,15 +915,15 @@ bool Cmd_ar_MapTo_Execute(COMMAND_ARGS)
 		return true;
 	auto& [eval, arr, transformScript] = ctx;
 	auto* returnArray = g_ArrayMap.Create(arr->KeyType(), arr->IsPacked(), scriptObj->GetModIndex());
-	for (auto iter = arr->Begin(); !iter.End(); ++iter)
+	UserFunctionBatch batch(transformScript);
+	InternalFunctionCaller caller(transformScript, thisObj, containingObj);
+	for (auto iter = arr->Begin(); !iter.End() && batch.IsGood(); ++iter)
 	{
-		InternalFunctionCaller caller(transformScript, thisObj, containingObj);
 		caller.SetArgs(1, ElementToIterator(scriptObj, iter)->ID());
-		auto tokenResult = UserFunctionManager::Call(std::move(caller));
-		if (!tokenResult)
+		if (!batch.Call(caller) || !batch.Result())
 			continue;
 		ArrayElement element;
-		if (BasicTokenToElem(tokenResult.get(), element))
+		if (BasicTokenToElem(batch.Result(), element))
 			returnArray->SetElement(iter.first(), &element);
 	}
 	*result = returnArray->ID();
@@ -937,11 +937,12 @@ bool Cmd_ar_ForEach_Execute(COMMAND_ARGS)
 	if (!ExtractArrayUDF(ctx))
 		return true;
 	auto& [eval, arr, functionScript] = ctx;
-	for (auto iter = arr->Begin(); !iter.End(); ++iter)
+	UserFunctionBatch batch(functionScript);
+	InternalFunctionCaller caller(functionScript, thisObj, containingObj);
+	for (auto iter = arr->Begin(); !iter.End() && batch.IsGood(); ++iter)
 	{
-		InternalFunctionCaller caller(functionScript, thisObj, containingObj);
 		caller.SetArgs(1, ElementToIterator(scriptObj, iter)->ID());
-		auto tokenResult = UserFunctionManager::Call(std::move(caller));
+		batch.Call(caller);
 	}
 	*result = 1;
 	return true;
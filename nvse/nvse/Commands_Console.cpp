@@ -123,6 +123,12 @@ bool Cmd_SetConsoleEcho_Execute(COMMAND_ARGS)
 	return true;
 };
 
+bool Cmd_GetConsolePrintOverflowCount_Execute(COMMAND_ARGS)
+{
+	*result = ConsolePrintQueue::GetOverflowCount();
+	return true;
+}
+
 bool Cmd_HasConsoleOutputFilename_Execute(COMMAND_ARGS)
 {
 	*result = ConsoleManager::HasConsoleOutputFilename();
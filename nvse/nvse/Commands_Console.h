@@ -11,6 +11,7 @@ DEFINE_CMD_ALT(SetDebugMode, dbmode, toggles debug mode for all scripts belongin
 DEFINE_CMD_ALT(GetDebugMode, GetDbMode, returns whether debug mode is set for the mod, 0, 1, kParams_OneOptionalInt);
 DEFINE_CMD_ALT(SetConsoleEcho, , toggles wether the engine echoes to the console and return previous state, 0, 1, kParams_OneInt);
 DEFINE_CMD_ALT(GetConsoleEcho, , returns whether the engine echoes to the console, 0, 1, kParams_OneOptionalInt);
+DEFINE_COMMAND(GetConsolePrintOverflowCount, returns how many printed lines went to nvse.log for being over the per-frame console line limit, 0, 0, NULL);
 
 DEFINE_CMD_ALT(HasConsoleOutputFilename, HasCOF, "return if there is a Console Output Filename active", 0, 0, NULL);
 DEFINE_CMD_ALT(GetConsoleOutputFilename, GetCOF, "returns the name of the Console Output Filename", 0, 0, NULL);
@@ -985,9 +985,79 @@ bool Cmd_GetEventHandlers_Execute(COMMAND_ARGS)
 	return true;
 }
 
-extern float g_gameSecondsPassed;
+void DelayedCallQueue::Add(DelayedCallInfo&& info)
+{
+	auto& heap = m_heaps[info.flags & (kHeap_MenuMode | kHeap_Strict)];
+	heap.push_back(Entry{std::move(info), m_nextOrder++});
+	std::push_heap(heap.begin(), heap.end(), std::greater<>());
+}
+
+bool DelayedCallQueue::IsDue(UInt32 heapIdx) const
+{
+	const auto& heap = m_heaps[heapIdx];
+	return !heap.empty() && GetDelayedCallClock(heap.front().info.flags) >= heap.front().info.time;
+}
+
+std::optional<DelayedCallInfo> DelayedCallQueue::PopDue(bool strictOnly)
+{
+	// deadlines on different clocks can't be compared, strict calls go first and ties fall back to the order of addition
+	SInt32 heapIdx = -1;
+	for (UInt32 i = strictOnly ? kHeap_Strict : 0; i < kNumHeaps; ++i)
+	{
+		if (!IsDue(i))
+			continue;
+		const bool isStrict = i & kHeap_Strict;
+		if (heapIdx == -1 || (isStrict && !(heapIdx & kHeap_Strict)) || m_heaps[i].front().order < m_heaps[heapIdx].front().order)
+			heapIdx = i;
+	}
+	if (heapIdx == -1)
+		return std::nullopt;
+	auto& heap = m_heaps[heapIdx];
+	std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+	std::optional<DelayedCallInfo> result(std::move(heap.back().info));
+	heap.pop_back();
+	return result;
+}
+
+bool DelayedCallQueue::HasDue() const
+{
+	for (UInt32 i = 0; i < kNumHeaps; ++i)
+		if (IsDue(i))
+			return true;
+	return false;
+}
+
+bool DelayedCallQueue::Empty() const
+{
+	return std::all_of(std::begin(m_heaps), std::end(m_heaps), [](const auto& heap) { return heap.empty(); });
+}
+
+UInt32 DelayedCallQueue::Size() const
+{
+	UInt32 size = 0;
+	for (const auto& heap : m_heaps)
+		size += heap.size();
+	return size;
+}
 
-bool ExtractCallAfterInfo(ExpressionEvaluator& eval, std::list<DelayedCallInfo>& infos, ICriticalSection& cs)
+void DelayedCallQueue::Clear()
+{
+	for (auto& heap : m_heaps)
+		heap.clear();
+}
+
+void AddDelayedCall(DelayedCallQueue& infos, DelayedCallInfo&& info)
+{
+	infos.Add(std::move(info));
+}
+
+void AddDelayedCall(std::list<DelayedCallInfo>& infos, DelayedCallInfo&& info)
+{
+	infos.push_back(std::move(info));
+}
+
+template <typename T_Infos>
+bool ExtractCallAfterInfo(ExpressionEvaluator& eval, T_Infos& infos, ICriticalSection& cs)
 {
 	auto const seconds = static_cast<float>(eval.Arg(0)->GetNumber());
 	Script* const callFunction = eval.Arg(1)->GetUserFunction();
@@ -1017,11 +1087,12 @@ bool ExtractCallAfterInfo(ExpressionEvaluator& eval, std::list<DelayedCallInfo>&
 	}
 
 	ScopedLock lock(cs);
-	infos.emplace_back(callFunction, g_gameSecondsPassed + seconds, eval.m_thisObj, flags, std::move(args));
+	AddDelayedCall(infos, DelayedCallInfo(callFunction, GetDelayedCallClock(flags) + seconds, eval.m_thisObj, flags, std::move(args)));
 	return true;
 }
 
-bool ExtractCallAfterInfo_OLD(COMMAND_ARGS, std::list<DelayedCallInfo>& infos, ICriticalSection& cs)
+template <typename T_Infos>
+bool ExtractCallAfterInfo_OLD(COMMAND_ARGS, T_Infos& infos, ICriticalSection& cs)
 {
 	float time;
 	Script* callFunction;
@@ -1029,12 +1100,13 @@ bool ExtractCallAfterInfo_OLD(COMMAND_ARGS, std::list<DelayedCallInfo>& infos, I
 	if (!ExtractArgs(EXTRACT_ARGS, &time, &callFunction, &runInMenuMode) || !callFunction || !IS_ID(callFunction, Script))
 		return false;
 
+	const auto flags = runInMenuMode ? DelayedCallInfo::kFlag_RunInMenuMode : DelayedCallInfo::kFlags_None;
 	ScopedLock lock(cs);
-	infos.emplace_back(callFunction, g_gameSecondsPassed + time, thisObj, runInMenuMode ? DelayedCallInfo::kFlag_RunInMenuMode : DelayedCallInfo::kFlags_None);
+	AddDelayedCall(infos, DelayedCallInfo(callFunction, GetDelayedCallClock(flags) + time, thisObj, flags));
 	return true;
 }
 
-std::list<DelayedCallInfo> g_callAfterInfos;
+DelayedCallQueue g_callAfterInfos;
 ICriticalSection g_callAfterInfosCS;
 
 bool Cmd_CallAfterSeconds_Execute(COMMAND_ARGS)
@@ -1072,10 +1144,54 @@ bool Cmd_CallForSeconds_OLD_Execute(COMMAND_ARGS)
 	return true;
 }
 
-bool ExtractCallWhileInfo(ExpressionEvaluator &eval, std::list<CallWhileInfo> &infos, ICriticalSection &cs)
+void CallWhileInfo::SetPollInterval(float interval)
+{
+	pollInterval = max(interval, 0.0F);
+	// golden ratio steps keep the phases of successive entries evenly spread over the interval
+	static float s_staggerPhase = 0;
+	float phase = 0;
+	if (flags & kFlag_StaggerPolls)
+	{
+		s_staggerPhase += 0.618034F;
+		s_staggerPhase -= static_cast<int>(s_staggerPhase);
+		phase = s_staggerPhase;
+	}
+	if (IntervalInFrames())
+		nextPollFrame = g_mainLoopFrames + static_cast<UInt32>(pollInterval * phase);
+	else
+		nextPollTime = g_gameSecondsPassed + pollInterval * phase;
+}
+
+bool CallWhileInfo::IsPollDue() const
 {
-	Script* callFunction = eval.Arg(0)->GetUserFunction();
-	Script* conditionFunction = eval.Arg(1)->GetUserFunction();
+	if (pollInterval <= 0)
+		return true;
+	if (IntervalInFrames())
+		return static_cast<SInt32>(g_mainLoopFrames - nextPollFrame) >= 0;
+	return g_gameSecondsPassed >= nextPollTime;
+}
+
+void CallWhileInfo::ScheduleNextPoll()
+{
+	if (pollInterval <= 0)
+		return;
+	if (IntervalInFrames())
+	{
+		nextPollFrame = g_mainLoopFrames + max(static_cast<UInt32>(pollInterval), 1U);
+		return;
+	}
+	// keep the phase unless the poll fell more than an interval behind
+	nextPollTime += pollInterval;
+	if (nextPollTime <= g_gameSecondsPassed)
+		nextPollTime = g_gameSecondsPassed + pollInterval;
+}
+
+bool ExtractCallWhileInfo(ExpressionEvaluator &eval, std::list<CallWhileInfo> &infos, ICriticalSection &cs, bool hasInterval = false)
+{
+	const UInt32 firstArg = hasInterval;
+	const float interval = hasInterval ? static_cast<float>(eval.Arg(0)->GetNumber()) : 0;
+	Script* callFunction = eval.Arg(firstArg)->GetUserFunction();
+	Script* conditionFunction = eval.Arg(firstArg + 1)->GetUserFunction();
 	if (!callFunction || !conditionFunction)
 		return false;
 
@@ -1084,11 +1200,11 @@ bool ExtractCallWhileInfo(ExpressionEvaluator &eval, std::list<CallWhileInfo> &i
 	CallArgs args{};
 
 	auto const numArgs = eval.NumArgs();
-	if (numArgs > 2)
+	if (numArgs > firstArg + 2)
 	{
-		flags = static_cast<CallWhileInfo::eFlags>(eval.Arg(2)->GetNumber());
-		args.reserve(numArgs - 3);
-		for (UInt32 i = 3; i < numArgs; i++)
+		flags = static_cast<CallWhileInfo::eFlags>(eval.Arg(firstArg + 2)->GetNumber());
+		args.reserve(numArgs - (firstArg + 3));
+		for (UInt32 i = firstArg + 3; i < numArgs; i++)
 		{
 			if (auto const tok = eval.Arg(i))
 			{
@@ -1103,6 +1219,8 @@ bool ExtractCallWhileInfo(ExpressionEvaluator &eval, std::list<CallWhileInfo> &i
 
 	ScopedLock lock(cs);
 	infos.emplace_back(callFunction, conditionFunction, eval.m_thisObj, flags, std::move(args));
+	if (hasInterval)
+		infos.back().SetPollInterval(interval);
 	return true;
 }
 bool ExtractCallWhileInfo_OLD(COMMAND_ARGS, std::list<CallWhileInfo>& infos, ICriticalSection& cs)
@@ -1160,6 +1278,137 @@ bool Cmd_CallWhen_OLD_Execute(COMMAND_ARGS)
 	return true;
 }
 
+bool Cmd_CallWhileInterval_Execute(COMMAND_ARGS)
+{
+	*result = false; //bSuccess
+	if (ExpressionEvaluator eval(PASS_COMMAND_ARGS);
+		eval.ExtractArgs())
+	{
+		*result = ExtractCallWhileInfo(eval, g_callWhileInfos, g_callWhileInfosCS, true);
+	}
+	return true;
+}
+
+bool Cmd_CallWhenInterval_Execute(COMMAND_ARGS)
+{
+	*result = false; //bSuccess
+	if (ExpressionEvaluator eval(PASS_COMMAND_ARGS);
+		eval.ExtractArgs())
+	{
+		*result = ExtractCallWhileInfo(eval, g_callWhenInfos, g_callWhenInfosCS, true);
+	}
+	return true;
+}
+
+namespace DeferredCallBudget
+{
+	static UInt64 s_budgetTicks = 0;	// 0 = unlimited
+	static UInt32 s_budgetMicroseconds = 0;
+	static LARGE_INTEGER s_frameStart;
+	static bool s_overrun = false;
+	static Stats s_stats;
+
+	static UInt64 TicksPerSecond()
+	{
+		static const UInt64 s_frequency = []
+		{
+			LARGE_INTEGER frequency;
+			QueryPerformanceFrequency(&frequency);
+			return static_cast<UInt64>(frequency.QuadPart);
+		}();
+		return s_frequency;
+	}
+
+	static UInt64 TicksSinceFrameStart()
+	{
+		LARGE_INTEGER now;
+		QueryPerformanceCounter(&now);
+		return now.QuadPart - s_frameStart.QuadPart;
+	}
+
+	void SetBudget(UInt32 microseconds)
+	{
+		s_budgetMicroseconds = microseconds;
+		s_budgetTicks = microseconds * TicksPerSecond() / 1000000;
+		if (microseconds && !s_budgetTicks)
+			s_budgetTicks = 1;
+	}
+
+	UInt32 GetBudget()
+	{
+		return s_budgetMicroseconds;
+	}
+
+	void BeginFrame()
+	{
+		s_overrun = false;
+		s_stats.conditionCalls = 0;
+		QueryPerformanceCounter(&s_frameStart);
+	}
+
+	bool HasTimeLeft()
+	{
+		return !s_budgetTicks || TicksSinceFrameStart() < s_budgetTicks;
+	}
+
+	void NoteOverrun()
+	{
+		s_overrun = true;
+	}
+
+	void NoteConditionCall()
+	{
+		++s_stats.conditionCalls;
+	}
+
+	void EndFrame(UInt32 queueDepth)
+	{
+		s_stats.lastFrameTicks = TicksSinceFrameStart();
+		s_stats.maxFrameTicks = max(s_stats.maxFrameTicks, s_stats.lastFrameTicks);
+		s_stats.queueDepth = queueDepth;
+		s_stats.maxQueueDepth = max(s_stats.maxQueueDepth, queueDepth);
+		++s_stats.frames;
+		s_stats.maxConditionCalls = max(s_stats.maxConditionCalls, s_stats.conditionCalls);
+		s_stats.totalConditionCalls += s_stats.conditionCalls;
+		if (s_overrun)
+			++s_stats.overrunFrames;
+	}
+
+	const Stats& GetStats()
+	{
+		return s_stats;
+	}
+}
+
+bool Cmd_SetDeferredCallBudget_Execute(COMMAND_ARGS)
+{
+	*result = DeferredCallBudget::GetBudget();
+	SInt32 microseconds;
+	if (ExtractArgs(EXTRACT_ARGS, &microseconds))
+		DeferredCallBudget::SetBudget(max(microseconds, 0));
+	return true;
+}
+
+bool Cmd_GetDeferredCallStats_Execute(COMMAND_ARGS)
+{
+	const auto& stats = DeferredCallBudget::GetStats();
+	const double microsPerTick = 1000000.0 / DeferredCallBudget::TicksPerSecond();
+
+	ArrayVar* arr = g_ArrayMap.Create(kDataType_String, false, scriptObj->GetModIndex());
+	*result = arr->ID();
+	arr->SetElementNumber("BudgetMicroseconds", DeferredCallBudget::GetBudget());
+	arr->SetElementNumber("Frames", stats.frames);
+	arr->SetElementNumber("OverrunFrames", stats.overrunFrames);
+	arr->SetElementNumber("QueueDepth", stats.queueDepth);
+	arr->SetElementNumber("MaxQueueDepth", stats.maxQueueDepth);
+	arr->SetElementNumber("LastFrameMicroseconds", stats.lastFrameTicks * microsPerTick);
+	arr->SetElementNumber("MaxFrameMicroseconds", stats.maxFrameTicks * microsPerTick);
+	arr->SetElementNumber("ConditionCalls", stats.conditionCalls);
+	arr->SetElementNumber("MaxConditionCalls", stats.maxConditionCalls);
+	arr->SetElementNumber("AvgConditionCalls", stats.frames ? static_cast<double>(stats.totalConditionCalls) / stats.frames : 0);
+	return true;
+}
+
 void DecompileScriptToFolder(const std::string& scriptName, Script* script, const std::string& fileExtension, const std::string_view& modName)
 {
 	ScriptParsing::ScriptAnalyzer analyzer(script);
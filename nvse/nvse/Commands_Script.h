@@ -225,6 +225,33 @@ static ParamInfo kNVSEParams_CallWhile[18] =
 	//#elems should not exceed max # of UDF args.
 };
 
+static ParamInfo kNVSEParams_CallWhileInterval[19] =
+{
+	{	"interval",	kNVSEParamType_Number,	0	},
+	{	"function",	kNVSEParamType_Form,	0	},
+	{	"condition",	kNVSEParamType_Form,0	},
+	{	"flags",		kNVSEParamType_Number,	1	},
+
+	{	"element",	kNVSEParamType_BasicType,	1	},
+	{	"element",	kNVSEParamType_BasicType,	1	},
+	{	"element",	kNVSEParamType_BasicType,	1	},
+	{	"element",	kNVSEParamType_BasicType,	1	},
+	{	"element",	kNVSEParamType_BasicType,	1	},
+
+	{	"element",	kNVSEParamType_BasicType,	1	},
+	{	"element",	kNVSEParamType_BasicType,	1	},
+	{	"element",	kNVSEParamType_BasicType,	1	},
+	{	"element",	kNVSEParamType_BasicType,	1	},
+	{	"element",	kNVSEParamType_BasicType,	1	},
+
+	{	"element",	kNVSEParamType_BasicType,	1	},
+	{	"element",	kNVSEParamType_BasicType,	1	},
+	{	"element",	kNVSEParamType_BasicType,	1	},
+	{	"element",	kNVSEParamType_BasicType,	1	},
+	{	"element",	kNVSEParamType_BasicType,	1	},
+	//#elems should not exceed max # of UDF args.
+};
+
 DEFINE_CMD_ALT(CallAfterSeconds_OLD, CallAfter_OLD, "deprecated", 0, std::size(kParams_CallAfter_OLD), kParams_CallAfter_OLD);
 DEFINE_CMD_ALT(CallForSeconds_OLD, CallFor_OLD, "deprecated", 0, std::size(kParams_CallAfter_OLD), kParams_CallAfter_OLD);
 DEFINE_COMMAND(CallWhile_OLD, "deprecated", 0, std::size(kParams_CallWhile_OLD), kParams_CallWhile_OLD);
@@ -234,6 +261,10 @@ DEFINE_CMD_ALT_EXP(CallAfterSeconds, CallAfter, "calls UDF after argument number
 DEFINE_CMD_ALT_EXP(CallForSeconds, CallFor, "calls UDF each frame for argument number of seconds", false, kNVSEParams_CallAfter);
 DEFINE_COMMAND_EXP(CallWhile, "calls UDF each frame while condition is met", false, kNVSEParams_CallWhile);
 DEFINE_COMMAND_EXP(CallWhen, "calls UDF once when a condition is met which is polled each frame", false, kNVSEParams_CallWhile);
+DEFINE_COMMAND_EXP(CallWhileInterval, "calls UDF every interval while condition is met, the interval is in seconds or in frames with flag 16", false, kNVSEParams_CallWhileInterval);
+DEFINE_COMMAND_EXP(CallWhenInterval, "calls UDF once when a condition is met which is polled every interval, the interval is in seconds or in frames with flag 16", false, kNVSEParams_CallWhileInterval);
+DEFINE_COMMAND(SetDeferredCallBudget, sets the per-frame time budget in microseconds for CallAfter/CallFor/CallWhile/CallWhen calls; 0 means unlimited, false, 1, kParams_OneInt);
+DEFINE_COMMAND(GetDeferredCallStats, returns a stringmap of queue depth/budget overrun metrics for CallAfter/CallFor/CallWhile/CallWhen calls, false, 0, NULL);
 
 #if RUNTIME
 using CallArgs = std::vector<SelfOwningArrayElement>;
@@ -247,10 +278,12 @@ struct DelayedCallInfo
 	enum eFlags : UInt8 {
 		kFlags_None = 0,
 		kFlag_RunInMenuMode = 1 << 0,
+		kFlag_Strict = 1 << 1,	// never held back by the deferred call budget
 	} flags;
 	CallArgs args;
 
 	[[nodiscard]] bool RunInMenuMode() const { return flags & kFlag_RunInMenuMode; }
+	[[nodiscard]] bool IsStrict() const { return flags & kFlag_Strict; }
 
 	DelayedCallInfo(Script* script, float time, TESObjectREFR* thisObj, eFlags flags, CallArgs &&args = {})
 		: script(script),
@@ -262,6 +295,53 @@ struct DelayedCallInfo
 	}
 };
 
+extern float g_gameSecondsPassed;		// advances every frame
+extern float g_gameModeSecondsPassed;	// stops while in menu mode
+extern UInt32 g_mainLoopFrames;
+
+// clock a delayed call counts down on, DelayedCallInfo::time is a deadline on it
+inline float GetDelayedCallClock(DelayedCallInfo::eFlags flags)
+{
+	return (flags & DelayedCallInfo::kFlag_RunInMenuMode) ? g_gameSecondsPassed : g_gameModeSecondsPassed;
+}
+
+// pending CallAfterSeconds calls, kept in one min-heap per clock so that only due entries are visited each frame
+// and entries paused by menu mode are never touched
+class DelayedCallQueue
+{
+	struct Entry
+	{
+		DelayedCallInfo info;
+		UInt32 order;	// breaks ties between equal deadlines in the order calls were added
+
+		bool operator>(const Entry& other) const
+		{
+			return info.time != other.info.time ? info.time > other.info.time : order > other.order;
+		}
+	};
+
+	enum
+	{
+		kHeap_MenuMode = 1 << 0,
+		kHeap_Strict = 1 << 1,
+		kNumHeaps = 4
+	};
+
+	std::vector<Entry> m_heaps[kNumHeaps];	// indexed by the kFlag_RunInMenuMode and kFlag_Strict bits
+	UInt32 m_nextOrder = 0;
+
+	[[nodiscard]] bool IsDue(UInt32 heapIdx) const;
+public:
+	void Add(DelayedCallInfo&& info);
+	// removes the due entry with the earliest deadline, if any; entries added while handling one are considered too
+	std::optional<DelayedCallInfo> PopDue(bool strictOnly = false);
+	[[nodiscard]] bool HasDue() const;
+
+	[[nodiscard]] bool Empty() const;
+	[[nodiscard]] UInt32 Size() const;
+	void Clear();
+};
+
 struct CallWhileInfo
 {
 	Script* callFunction;
@@ -274,11 +354,26 @@ struct CallWhileInfo
 		kPassArgs_ToCallFunc = 1 << 0,
 		kPassArgs_ToConditionFunc = 1 << 1,
 		kFlag_RunInMenuMode = 1 << 2,	//todo: make use (?)
+		kFlag_Strict = 1 << 3,	// never held back by the deferred call budget
+		kFlag_IntervalInFrames = 1 << 4,
+		kFlag_StaggerPolls = 1 << 5,	// spread the first poll of entries with the same interval over that interval
 	} flags;
 	CallArgs args;
+	float pollInterval = 0;	// 0 = poll every frame
+	union
+	{
+		float nextPollTime = 0;		// on g_gameSecondsPassed
+		UInt32 nextPollFrame;		// on g_mainLoopFrames, with kFlag_IntervalInFrames
+	};
 
 	[[nodiscard]] bool PassArgsToCallFunc() const { return flags & kPassArgs_ToCallFunc; }
 	[[nodiscard]] bool PassArgsToCondFunc() const { return flags & kPassArgs_ToConditionFunc; }
+	[[nodiscard]] bool IsStrict() const { return flags & kFlag_Strict; }
+	[[nodiscard]] bool IntervalInFrames() const { return flags & kFlag_IntervalInFrames; }
+
+	void SetPollInterval(float interval);
+	[[nodiscard]] bool IsPollDue() const;
+	void ScheduleNextPoll();
 
 	CallWhileInfo(Script* callFunction, Script* condition, TESObjectREFR* thisObj, eFlags flags, CallArgs &&args = {})
 		: callFunction(callFunction),
@@ -294,7 +389,7 @@ struct CallWhileInfo
 
 extern std::list<DelayedCallInfo> g_callForInfos;
 extern std::list<CallWhileInfo> g_callWhileInfos;
-extern std::list<DelayedCallInfo> g_callAfterInfos;
+extern DelayedCallQueue g_callAfterInfos;
 extern std::list<CallWhileInfo> g_callWhenInfos;
 
 extern ICriticalSection g_callForInfosCS;
@@ -302,6 +397,35 @@ extern ICriticalSection g_callWhileInfosCS;
 extern ICriticalSection g_callAfterInfosCS;
 extern ICriticalSection g_callWhenInfosCS;
 
+// Per-frame time budget shared by the CallAfter/CallFor/CallWhile/CallWhen handlers in the main loop.
+// Once it is spent, calls not flagged as strict wait for the next frame, where they are the first to run.
+namespace DeferredCallBudget
+{
+	struct Stats
+	{
+		UInt32 frames = 0;
+		UInt32 overrunFrames = 0;	// frames that ran out of budget with calls still pending
+		UInt32 queueDepth = 0;		// calls pending at the end of the last frame
+		UInt32 maxQueueDepth = 0;
+		UInt64 lastFrameTicks = 0;	// time spent in the handlers during the last frame
+		UInt64 maxFrameTicks = 0;
+		UInt32 conditionCalls = 0;	// CallWhile/CallWhen condition polls during the last frame
+		UInt32 maxConditionCalls = 0;
+		UInt64 totalConditionCalls = 0;
+	};
+
+	void SetBudget(UInt32 microseconds);
+	UInt32 GetBudget();
+
+	void BeginFrame();
+	[[nodiscard]] bool HasTimeLeft();
+	void NoteOverrun();
+	void NoteConditionCall();
+	void EndFrame(UInt32 queueDepth);
+
+	const Stats& GetStats();
+}
+
 #endif
 
 static ParamInfo kParams_HasScriptCommand[3] =
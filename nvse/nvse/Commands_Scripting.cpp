@@ -293,7 +293,7 @@ bool Cmd_ToString_Execute(COMMAND_ARGS)
 		else if (eval.Arg(0)->CanConvertTo(kTokenType_Number))
 		{
 			char buf[0x20];
-			snprintf(buf, sizeof(buf), "%g", eval.Arg(0)->GetNumber());
+			NumToStr(buf, eval.Arg(0)->GetNumber());
 			tokenAsString = buf;
 		}
 		else if (eval.Arg(0)->CanConvertTo(kTokenType_Form))
@@ -714,6 +714,77 @@ bool Cmd_GetSelfAlt_Execute(COMMAND_ARGS)
 	return true;
 }
 
+bool Cmd_ClearUDFCache_Execute(COMMAND_ARGS)
+{
+	*result = 0;
+	TESForm* form = nullptr;
+	if (!ExtractArgsEx(EXTRACT_ARGS_EX, &form))
+		return true;
+	Script* funcScript = form ? DYNAMIC_CAST(form, TESForm, Script) : nullptr;
+	if (form && !funcScript)
+		return true;
+	UserFunctionManager::ClearMemoizedResults(funcScript);
+	*result = 1;
+	return true;
+}
+
+bool Cmd_GetUDFCacheStats_Execute(COMMAND_ARGS)
+{
+	*result = 0;
+	TESForm* form = nullptr;
+	if (!ExtractArgsEx(EXTRACT_ARGS_EX, &form))
+		return true;
+	Script* funcScript = form ? DYNAMIC_CAST(form, TESForm, Script) : nullptr;
+	if (form && !funcScript)
+		return true;
+
+	const MemoizedStats stats = UserFunctionManager::GetMemoizedStats(funcScript);
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	const double microsPerTick = 1000000.0 / frequency.QuadPart;
+
+	ArrayVar* arr = g_ArrayMap.Create(kDataType_String, false, scriptObj->GetModIndex());
+	*result = arr->ID();
+	arr->SetElementNumber("Hits", stats.hits);
+	arr->SetElementNumber("Misses", stats.misses);
+	arr->SetElementNumber("Entries", stats.entries);
+	const UInt32 numCalls = stats.hits + stats.misses;
+	arr->SetElementNumber("HitRate", numCalls ? static_cast<double>(stats.hits) / numCalls : 0);
+	arr->SetElementNumber("AvgHitMicroseconds", stats.hits ? stats.hitTicks * microsPerTick / stats.hits : 0);
+	arr->SetElementNumber("AvgMissMicroseconds", stats.misses ? stats.missTicks * microsPerTick / stats.misses : 0);
+	return true;
+}
+
+bool Cmd_SetRuntimeErrorRepeatLimit_Execute(COMMAND_ARGS)
+{
+	*result = RuntimeErrorThrottle::GetRepeatLimit();
+	SInt32 limit;
+	if (ExtractArgs(EXTRACT_ARGS, &limit))
+		RuntimeErrorThrottle::SetRepeatLimit(max(limit, 0));
+	return true;
+}
+
+bool Cmd_GetRuntimeErrorStats_Execute(COMMAND_ARGS)
+{
+	*result = 0;
+	TESForm* form = nullptr;
+	if (!ExtractArgsEx(EXTRACT_ARGS_EX, &form))
+		return true;
+	Script* errorScript = form ? DYNAMIC_CAST(form, TESForm, Script) : nullptr;
+	if (form && !errorScript)
+		return true;
+
+	const auto stats = RuntimeErrorThrottle::GetStats(errorScript);
+	ArrayVar* arr = g_ArrayMap.Create(kDataType_String, false, scriptObj->GetModIndex());
+	*result = arr->ID();
+	arr->SetElementNumber("Total", stats.total);
+	arr->SetElementNumber("Shown", stats.shown);
+	arr->SetElementNumber("Suppressed", stats.suppressed);
+	arr->SetElementNumber("Sites", stats.sites);
+	arr->SetElementNumber("RepeatLimit", RuntimeErrorThrottle::GetRepeatLimit());
+	return true;
+}
+
 #endif
 
 bool Cmd_Let_Parse(UInt32 numParams, ParamInfo* paramInfo, ScriptLineBuffer* lineBuf, ScriptBuffer* scriptBuf)
@@ -75,4 +75,9 @@ static ParamInfo kParams_OneBoolean[] =
 
 DEFINE_CMD_ALT_EXP(PrintVar, PrintV, , false, kParams_OneNVSEVariable);
 DEFINE_CMD_ALT_EXP(Assert, AssertTrue, , false, kParams_OneBoolean);
-DEFINE_CMD_ALT_EXP(GetSelfAlt, ThisAlt, "Unlike GetSelf, will return ThisObj even if it isn't Persistent and is clutter.", false, nullptr);
\ No newline at end of file
+DEFINE_CMD_ALT_EXP(GetSelfAlt, ThisAlt, "Unlike GetSelf, will return ThisObj even if it isn't Persistent and is clutter.", false, nullptr);
+
+DEFINE_COMMAND(ClearUDFCache, clears the memoized results of a pure function script or of all of them, 0, 1, kParams_OneOptionalForm);
+DEFINE_COMMAND(GetUDFCacheStats, returns a stringmap of memoization hits/misses/timings for a pure function script or all of them, 0, 1, kParams_OneOptionalForm);
+DEFINE_COMMAND(SetRuntimeErrorRepeatLimit, sets how many times the same script error is shown per 5 seconds before further repeats are only counted; 0 means unlimited, 0, 1, kParams_OneInt);
+DEFINE_COMMAND(GetRuntimeErrorStats, returns a stringmap of raised/shown/suppressed runtime error counts for a script or all of them, 0, 1, kParams_OneOptionalForm);
\ No newline at end of file
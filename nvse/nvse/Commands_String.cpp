@@ -247,7 +247,7 @@ bool Cmd_sv_ToNumeric_Execute(COMMAND_ARGS)
 	if (strVar)
 	{
 		const char *cStr = strVar->GetCString();
-		*result = strtod(cStr + startPos, NULL);
+		*result = StrToDbl(cStr + startPos);
 	}
 
 	return true;
@@ -945,15 +945,10 @@ bool Cmd_sv_Split_Execute(COMMAND_ARGS)
 	ExpressionEvaluator eval(PASS_COMMAND_ARGS);
 	if (eval.ExtractArgs() && eval.NumArgs() == 2 && eval.Arg(0)->CanConvertTo(kTokenType_String) && eval.Arg(1)->CanConvertTo(kTokenType_String))
 	{
-		Tokenizer tokens(eval.Arg(0)->GetString(), eval.Arg(1)->GetString());
-		std::string token;
-
-		double idx = 0;
-		while (tokens.NextToken(token) != -1)
-		{
-			arr->SetElementString(idx, token.c_str());
-			idx += 1;
-		}
+		const char *src = eval.Arg(0)->GetString();
+		Vector<TokenSpan> tokens(0x40);
+		SplitTokens(src, StrLen(src), eval.Arg(1)->GetString(), tokens);
+		arr->AppendStrings(src, tokens.Data(), tokens.Size());
 	}
 
 	return true;
@@ -120,7 +120,7 @@ void Core_PreLoadCallback(void * reserved)
 
 	g_callWhileInfos.clear();
 	g_callForInfos.clear();
-	g_callAfterInfos.clear();
+	g_callAfterInfos.Clear();
 	g_callWhenInfos.clear();
 
 	for (auto iter = EventManager::s_eventInfos.begin(); iter != EventManager::s_eventInfos.end(); ++iter)
@@ -127,6 +127,9 @@ public:
 		if (!m_eval.ExtractArgs())
 			return false;
 
+		ScriptLocal* paramVars[kMaxUdfParams];
+		info->GetParamVars(eventList, paramVars);
+
 		// populate event list variables
 		for (UInt32 i = 0; i < m_eval.NumArgs(); i++)
 		{
@@ -139,7 +142,7 @@ public:
 				return false;
 			}
 
-			ScriptLocal* var = eventList->GetVariable(param->varIdx);
+			ScriptLocal* var = paramVars[i];
 			if (!var)
 			{
 				ShowRuntimeError(info->GetScript(), "Param variable not found. Function definition may be out of sync with function call. Recomplie the scripts and try again.");
@@ -296,6 +299,76 @@ void UserFunctionManager::ClearInfos()
 	GetSingleton()->m_functionInfos.Clear();
 }
 
+void UserFunctionManager::ClearMemoizedResults(Script* funcScript)
+{
+	if (!funcScript)
+	{
+		MemoizedResults::ClearAll();
+		return;
+	}
+	if (FunctionInfo* info = GetSingleton()->m_functionInfos.GetPtr(funcScript))
+	{
+		if (MemoizedResults* memoized = info->GetMemoizedResults())
+			memoized->Clear();
+	}
+}
+
+MemoizedStats UserFunctionManager::GetMemoizedStats(Script* funcScript)
+{
+	MemoizedStats total;
+	for (auto iter = GetSingleton()->m_functionInfos.Begin(); !iter.End(); ++iter)
+	{
+		const MemoizedResults* memoized = iter.Get().GetMemoizedResults();
+		if (!memoized || (funcScript && iter.Key() != funcScript))
+			continue;
+		total.hits += memoized->stats.hits;
+		total.misses += memoized->stats.misses;
+		total.entries += memoized->Size();
+		total.hitTicks += memoized->stats.hitTicks;
+		total.missTicks += memoized->stats.missTicks;
+	}
+	return total;
+}
+
+/*****************************
+	MemoizedResults
+*****************************/
+
+std::atomic<int> MemoizedResults::s_clearToken = 0;
+
+const ScriptToken* MemoizedResults::Get(const std::string& key)
+{
+	if (m_clearToken != s_clearToken)
+	{
+		m_clearToken = s_clearToken;
+		Clear();
+	}
+	const auto iter = m_index.find(key);
+	if (iter == m_index.end())
+		return nullptr;
+	m_entries.splice(m_entries.begin(), m_entries, iter->second);
+	return iter->second->second.get();
+}
+
+void MemoizedResults::Insert(std::string&& key, std::unique_ptr<ScriptToken> result)
+{
+	if (m_index.contains(key)) // already added by a recursive call
+		return;
+	if (m_entries.size() >= kMaxEntries)
+	{
+		m_index.erase(m_entries.back().first);
+		m_entries.pop_back();
+	}
+	m_entries.emplace_front(std::move(key), std::move(result));
+	m_index.emplace(m_entries.front().first, m_entries.begin());
+}
+
+void MemoizedResults::Clear()
+{
+	m_index.clear();
+	m_entries.clear();
+}
+
 /*****************************
 	FunctionInfo
 *****************************/
@@ -374,9 +447,34 @@ FunctionInfo::FunctionInfo(Script* script)
 		params.emplace_back(idx, static_cast<Script::VariableType>(type));
 	}
 
+	// deprecated local array var indexes, then optional flags (see ExpressionParser::ParseUserFunctionDefinition)
+	const UInt8* dataEnd = script->data + min(8 + *reinterpret_cast<UInt16*>(script->data + 6), script->info.dataLength);
+	if (data < dataEnd)
+	{
+		data += 1 + *data * 2;
+		if (data < dataEnd)
+			m_flags = *data;
+	}
+
 	m_dParamInfo = DynamicParamInfo(params);
 	m_userFunctionParams = std::move(params);
 
+	for (UInt32 i = 0; i < m_userFunctionParams.size() && i < kMaxUdfParams; i++)
+	{
+		const UInt16 varIdx = m_userFunctionParams[i].varIdx;
+		if (varIdx >= m_paramSlots.size())
+			m_paramSlots.resize(varIdx + 1, kNoParamSlot);
+		if (m_paramSlots[varIdx] == kNoParamSlot)
+		{
+			m_paramSlots[varIdx] = i;
+			m_numParamSlots++;
+		}
+	}
+
+	// captured variables aren't part of the key, ParseLambda rejects pure lambdas that read them
+	if (IsPure())
+		m_memoizedResults = std::make_unique<MemoizedResults>();
+
 	if (!m_isLambda)
 	{
 		// construct event list
@@ -404,6 +502,32 @@ FunctionInfo::~FunctionInfo()
 {
 	if (m_eventList)
 		OtherHooks::DeleteEventList(m_eventList);
+	for (auto* eventList : m_eventListPool)
+		OtherHooks::DeleteEventList(eventList);
+}
+
+// recursion can't exceed the nest depth, so neither can the number of lists in use at once
+static constexpr UInt32 kMaxPooledEventLists = 30;
+
+ScriptEventList* FunctionInfo::AcquireEventList()
+{
+	if (m_eventListPool.Empty())
+		return m_script->CreateEventList();
+	ScriptEventList* eventList = m_eventListPool.Top();
+	m_eventListPool.Pop();
+	return eventList;
+}
+
+void FunctionInfo::ReleaseEventList(ScriptEventList* eventList)
+{
+	if (m_eventListPool.Size() >= kMaxPooledEventLists)
+	{
+		OtherHooks::DeleteEventList(eventList);
+		return;
+	}
+	// zeroes the variables and drops string/array references held by them, same as for the cached list
+	eventList->ResetAllVariables();
+	m_eventListPool.Append(eventList);
 }
 
 FunctionContext* FunctionInfo::CreateContext(UInt8 version, Script* invokingScript)
@@ -443,6 +567,136 @@ UInt32 FunctionInfo::GetParamVarTypes(UInt8* out) const
 	return count;
 }
 
+void FunctionInfo::GetParamVars(ScriptEventList* eventList, ScriptLocal* (&paramVars)[kMaxUdfParams]) const
+{
+	std::fill_n(paramVars, kMaxUdfParams, nullptr);
+	const UInt32 numParams = min(m_userFunctionParams.size(), kMaxUdfParams);
+	if (m_isLambda)
+	{
+		// parent event list, usually much larger than the params and reused across calls
+		for (UInt32 i = 0; i < numParams; i++)
+			paramVars[i] = eventList->GetVariableIndexed(m_userFunctionParams[i].varIdx);
+		return;
+	}
+	// single walk over the var list, stops once every param has its variable
+	UInt32 numFound = 0;
+	for (auto* var : *eventList->m_vars)
+	{
+		if (numFound == m_numParamSlots)
+			break;
+		if (!var || var->id >= m_paramSlots.size())
+			continue;
+		const UInt8 slot = m_paramSlots[var->id];
+		if (slot != kNoParamSlot && !paramVars[slot])
+		{
+			paramVars[slot] = var;
+			numFound++;
+		}
+	}
+	if (numFound != numParams)
+	{
+		// params sharing a variable
+		for (UInt32 i = 0; i < numParams; i++)
+		{
+			if (!paramVars[i])
+				paramVars[i] = eventList->GetVariable(m_userFunctionParams[i].varIdx);
+		}
+	}
+}
+
+// appends the key type, keys and values of an array, nested arrays by their own contents
+// since array IDs are reused once freed; false if nested too deep (or self-referencing) to key
+static bool AppendArrayMemoKey(std::string& key, ArrayID arrID, UInt32 depth)
+{
+	ArrayVar* arr = g_ArrayMap.Get(arrID);
+	if (!arr)
+	{
+		key.push_back(0);
+		return true;
+	}
+	if (depth >= 8)
+		return false;
+	key.push_back(static_cast<char>(arr->KeyType()));
+	const UInt32 size = arr->Size();
+	key.append(reinterpret_cast<const char*>(&size), sizeof size);
+	for (auto iter = arr->Begin(); !iter.End(); ++iter)
+	{
+		// the key is a static object for lists, so read it before recursing
+		const ArrayKey* arrKey = iter.first();
+		if (arrKey->KeyType() == kDataType_String)
+		{
+			const char* str = arrKey->key.GetStr();
+			key.append(str, strlen(str) + 1);
+		}
+		else
+			key.append(reinterpret_cast<const char*>(&arrKey->key.num), sizeof arrKey->key.num);
+
+		const ArrayElement* elem = iter.second();
+		key.push_back(static_cast<char>(elem->DataType()));
+		switch (elem->DataType())
+		{
+		case kDataType_String:
+		{
+			const char* str = elem->m_data.GetStr();
+			key.append(str, strlen(str) + 1);
+			break;
+		}
+		case kDataType_Array:
+			if (!AppendArrayMemoKey(key, elem->m_data.arrID, depth + 1))
+				return false;
+			break;
+		case kDataType_Form:
+			key.append(reinterpret_cast<const char*>(&elem->m_data.formID), sizeof elem->m_data.formID);
+			break;
+		default:
+			key.append(reinterpret_cast<const char*>(&elem->m_data.num), sizeof elem->m_data.num);
+			break;
+		}
+	}
+	return true;
+}
+
+bool FunctionInfo::MakeMemoKey(ScriptEventList* eventList, TESObjectREFR* thisObj, TESObjectREFR* containingObj, std::string& key) const
+{
+	ScriptLocal* paramVars[kMaxUdfParams];
+	GetParamVars(eventList, paramVars);
+
+	// the calling and containing refs count as arguments, as GetSelf, GetContainer etc. may depend on them
+	const UInt32 refIDs[] = {thisObj ? thisObj->refID : 0, containingObj ? containingObj->refID : 0};
+	key.append(reinterpret_cast<const char*>(refIDs), sizeof refIDs);
+
+	const UInt32 numParams = min(m_userFunctionParams.size(), kMaxUdfParams);
+	for (UInt32 i = 0; i < numParams; i++)
+	{
+		const ScriptLocal* var = paramVars[i];
+		if (!var)
+		{
+			key.push_back(0);
+			continue;
+		}
+		switch (m_userFunctionParams[i].varType)
+		{
+		case Script::eVarType_String:
+		{
+			// string vars are created anew for each call, key on their contents
+			StringVar* strVar = g_StringMap.Get(static_cast<int>(var->data));
+			const char* str = strVar ? strVar->GetCString() : "";
+			key.append(str, strlen(str) + 1);
+			break;
+		}
+		case Script::eVarType_Array:
+			// a freed temp array's ID goes to the next new array, so the ID alone can't tell two calls apart
+			if (!AppendArrayMemoKey(key, static_cast<ArrayID>(var->data), 0))
+				return false;
+			break;
+		default:
+			key.append(reinterpret_cast<const char*>(&var->data), sizeof var->data);
+			break;
+		}
+	}
+	return true;
+}
+
 bool FunctionInfo::Execute(FunctionCaller& caller, FunctionContext* context)
 {
 	// this should never happen as max function call depth is capped at 30
@@ -482,12 +736,12 @@ m_bad(true), m_lambdaBackupEventList(false)
 		if (!m_eventList)
 		{
 			m_lambdaBackupEventList = true;
-			m_eventList = info->GetScript()->CreateEventList();
+			m_eventList = info->AcquireEventList();
 		}
 	}
 	else if (info->IsActive())
 	{
-		m_eventList = info->GetScript()->CreateEventList();
+		m_eventList = info->AcquireEventList();
 	}
 	else
 	{
@@ -510,6 +764,16 @@ m_bad(true), m_lambdaBackupEventList(false)
 	m_bad = false;
 }
 
+void FunctionContext::Reset()
+{
+	if (m_eventList && (!m_info->m_isLambda || m_lambdaBackupEventList))
+	{
+		LambdaManager::MarkParentAsDeleted(m_eventList);
+		m_eventList->ResetAllVariables();
+	}
+	m_result = nullptr;
+}
+
 FunctionContext::~FunctionContext()
 {
 #ifdef DBG_EXPR_LEAKS
@@ -522,7 +786,7 @@ FunctionContext::~FunctionContext()
 
 		if (m_eventList != m_info->GetEventList()) // check if bottom of call stack (first is always cached)
 		{
-			OtherHooks::DeleteEventList(m_eventList);
+			m_info->ReleaseEventList(m_eventList);
 		}
 		else
 		{
@@ -542,7 +806,14 @@ void ExecuteSingleLineLambda(FunctionInfo* info, FunctionCaller& caller, ScriptE
 	OtherHooks::PopScriptContext();
 }
 
-bool FunctionContext::Execute(FunctionCaller& caller) const
+static UInt64 TicksSince(const LARGE_INTEGER& start)
+{
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	return now.QuadPart - start.QuadPart;
+}
+
+bool FunctionContext::Execute(FunctionCaller& caller)
 {
 	if (!IsGood())
 		return false;
@@ -551,11 +822,37 @@ bool FunctionContext::Execute(FunctionCaller& caller) const
 	if (!caller.PopulateArgs(m_eventList, m_info))
 		return false;
 
+	MemoizedResults* memoized = m_info->GetMemoizedResults();
+	std::string memoKey;
+	LARGE_INTEGER startTime;
+	if (memoized)
+	{
+		QueryPerformanceCounter(&startTime);
+		if (!m_info->MakeMemoKey(m_eventList, caller.ThisObj(), caller.ContainingObj(), memoKey))
+			memoized = nullptr;	// args can't be keyed, run uncached
+		else if (const ScriptToken* cached = memoized->Get(memoKey))
+		{
+			m_result = cached->ToBasicToken();
+			memoized->stats.hits++;
+			memoized->stats.hitTicks += TicksSince(startTime);
+			return true;
+		}
+	}
+
 	if (m_info->m_singleLineLambdaPosition) // performance optimization for {} => ... lambdas
 		ExecuteSingleLineLambda(m_info, caller, m_eventList);
 	else
 		// run the script
 		CALL_MEMBER_FN(m_info->GetScript(), Execute)(caller.ThisObj(), m_eventList, caller.ContainingObj(), false);
+
+	if (memoized)
+	{
+		// returned arrays can be modified or destroyed by the caller, so they are never cached
+		if (m_result && m_result->Type() != kTokenType_Array)
+			memoized->Insert(std::move(memoKey), m_result->ToBasicToken());
+		memoized->stats.misses++;
+		memoized->stats.missTicks += TicksSince(startTime);
+	}
 	return true;
 }
 
@@ -570,6 +867,68 @@ bool FunctionContext::Return(ExpressionEvaluator* eval)
 	return true;
 }
 
+/*******************************
+	UserFunctionBatch
+*******************************/
+
+UserFunctionBatch::UserFunctionBatch(Script* funcScript, Script* invokingScript) : m_script(funcScript)
+{
+	if (!funcScript)
+	{
+		ShowRuntimeError(nullptr, "Could not extract function script.");
+		return;
+	}
+	if (!funcScript->data)
+		return;
+
+	m_info = UserFunctionManager::GetSingleton()->GetFunctionInfo(funcScript);
+	if (!m_info)
+	{
+		ShowRuntimeError(funcScript, "Could not parse function info for function script");
+		return;
+	}
+
+	m_context = m_info->CreateContext(UserFunctionManager::kVersion, invokingScript);
+	if (!m_context)
+		ShowRuntimeError(funcScript, "Could not create function context for function script");
+}
+
+UserFunctionBatch::~UserFunctionBatch()
+{
+	delete m_context;
+}
+
+bool UserFunctionBatch::Call(FunctionCaller& caller)
+{
+	if (!m_context)
+		return false;
+
+	UserFunctionManager* funcMan = UserFunctionManager::GetSingleton();
+	if (funcMan->m_nestDepth >= UserFunctionManager::kMaxNestDepth)
+	{
+		ShowRuntimeError(nullptr, "Max nest depth %d exceeded in function call.", UserFunctionManager::kMaxNestDepth);
+		return false;
+	}
+
+	if (m_numCalls++)
+		m_context->Reset();
+
+	funcMan->Push(m_context);
+	funcMan->m_nestDepth++;
+	const bool bResult = m_info->Execute(caller, m_context);
+	funcMan->m_nestDepth--;
+
+	if (funcMan->Top(m_script) != m_context)
+	{
+		// leave the context to the stack like UserFunctionManager::Call does, and stop the batch
+		ShowRuntimeError(m_script, "Call stack is corrupted on return from call to function script");
+		m_context = nullptr;
+		return false;
+	}
+	funcMan->m_functionStack.Pop();
+	return bResult;
+}
+
 /*******************************
 	InternalFunctionCaller
 *******************************/
@@ -582,6 +941,9 @@ bool InternalFunctionCaller::PopulateArgs(ScriptEventList* eventList, FunctionIn
 		return false;
 	}
 
+	ScriptLocal* paramVars[kMaxUdfParams];
+	info->GetParamVars(eventList, paramVars);
+
 	// populate the args in the event list
 	for (ParamSize_t i = 0; i < m_numArgs; i++)
 	{
@@ -592,7 +954,7 @@ bool InternalFunctionCaller::PopulateArgs(ScriptEventList* eventList, FunctionIn
 			return false;
 		}
 
-		ScriptLocal* var = eventList->GetVariable(param->varIdx);
+		ScriptLocal* var = paramVars[i];
 		if (!var)
 		{
 			ShowRuntimeError(m_script, "Could not look up argument variable for function script");
@@ -681,6 +1043,9 @@ bool InternalFunctionCallerAlt::PopulateArgs(ScriptEventList* eventList, Functio
 		return false;
 	}
 
+	ScriptLocal* paramVars[kMaxUdfParams];
+	info->GetParamVars(eventList, paramVars);
+
 	// populate the args in the event list
 	for (ParamSize_t i = 0; i < m_numArgs; i++)
 	{
@@ -691,7 +1056,7 @@ bool InternalFunctionCallerAlt::PopulateArgs(ScriptEventList* eventList, Functio
 			return false;
 		}
 
-		ScriptLocal* var = eventList->GetVariable(param->varIdx);
+		ScriptLocal* var = paramVars[i];
 		if (!var)
 		{
 			ShowRuntimeError(m_script, "Could not look up argument variable for function script");
@@ -746,6 +1111,8 @@ bool ArrayElementArgFunctionCaller<T>::PopulateArgs(ScriptEventList* eventList,
 	auto const numArgs = m_args->size();
 	if (numArgs > kMaxUdfParams)
 		return false;
+	ScriptLocal* paramVars[kMaxUdfParams];
+	info->GetParamVars(eventList, paramVars);
 	// populate the args in the event list
 	for (UInt32 i = 0; i < numArgs; i++)
 	{
@@ -755,7 +1122,7 @@ bool ArrayElementArgFunctionCaller<T>::PopulateArgs(ScriptEventList* eventList,
 			ShowRuntimeError(m_script, "Failed to extract parameter %d. Please verify the number of parameters in function script match those required for event.", i);
 			return false;
 		}
-		ScriptLocal* var = eventList->GetVariable(param->varIdx);
+		ScriptLocal* var = paramVars[i];
 		if (!var)
 		{
 			ShowRuntimeError(m_script, "Could not look up argument variable for function script");
@@ -894,4 +1261,28 @@ namespace PluginAPI
 		}
 		return false;
 	}
+
+	UInt32 CallFunctionScriptBatch(Script* fnScript, TESObjectREFR* callingObj, TESObjectREFR* container,
+		UInt8 numArgs, void* const* args, UInt32 numCalls, NVSEArrayVarInterface::Element* results)
+	{
+		UserFunctionBatch batch(fnScript);
+		InternalFunctionCaller caller(fnScript, callingObj, container);
+		UInt32 numSucceeded = 0;
+		for (UInt32 i = 0; i < numCalls && batch.IsGood(); i++, args += numArgs)
+		{
+			if (!caller.SetArgsRaw(numArgs, args))
+				break;
+			const bool called = batch.Call(caller);
+			if (!results)
+			{
+				numSucceeded += called;
+				continue;
+			}
+			if (called && batch.Result())
+				numSucceeded += BasicTokenToPluginElem(batch.Result(), results[i], fnScript);
+			else
+				results[i] = NVSEArrayVarInterface::Element();
+		}
+		return numSucceeded;
+	}
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include "ScriptUtils.h"
 #include <unordered_map>
+#include <list>
+#include <atomic>
 #include "FastStack.h"
 
 struct UserFunctionParam
@@ -12,10 +14,51 @@ struct UserFunctionParam
 	UserFunctionParam() : varIdx(-1), varType(Script::eVarType_Invalid) { }
 };
 
+// trailing flags byte of the Begin Function bytecode
+enum UserFunctionFlags : UInt8
+{
+	kUserFunctionFlag_Pure = 1 << 0,	// result depends only on the args and calling/containing refs, so it can be memoized
+};
+
 #if RUNTIME
 
 struct FunctionContext;
 
+struct MemoizedStats
+{
+	UInt32 hits = 0;
+	UInt32 misses = 0;
+	UInt32 entries = 0;
+	UInt64 hitTicks = 0;	// QueryPerformanceCounter ticks spent in calls answered from the cache
+	UInt64 missTicks = 0;	// and in calls that ran the function
+};
+
+// bounded LRU of the results of a pure function script, keyed by argument values (see FunctionInfo::MakeMemoKey)
+class MemoizedResults
+{
+	using Entry = std::pair<std::string, std::unique_ptr<ScriptToken>>;
+
+	std::list<Entry> m_entries;	// most recently used first
+	std::unordered_map<std::string_view, std::list<Entry>::iterator> m_index;	// views into m_entries keys
+	int m_clearToken;
+
+	static std::atomic<int> s_clearToken;
+public:
+	static constexpr UInt32 kMaxEntries = 256;
+
+	MemoizedStats stats;
+
+	MemoizedResults() : m_clearToken(s_clearToken) {}
+
+	[[nodiscard]] const ScriptToken* Get(const std::string& key);
+	void Insert(std::string&& key, std::unique_ptr<ScriptToken> result);
+	void Clear();
+	[[nodiscard]] UInt32 Size() const { return m_entries.size(); }
+
+	// drops the results of every pure function on every thread, e.g. on game load
+	static void ClearAll() { ++s_clearToken; }
+};
+
 // base class for Template Method-ish objects to execute function scripts
 // derive from it to allow function scripts to be invoked from script or internal code
 class FunctionCaller
@@ -43,11 +86,18 @@ struct FunctionInfo
 	bool				m_bad;
 	UInt8				m_instanceCount;
 	ScriptEventList* m_eventList;		// cached for quicker construction of function script, but requires care when dealing with recursive function calls
+	Vector<ScriptEventList*> m_eventListPool;	// reset lists for recursive calls and parentless lambdas, see AcquireEventList
 #if _DEBUG
 	const char* editorID;
 #endif
 	UInt8* m_singleLineLambdaPosition = nullptr;
 	bool				m_isLambda;
+	std::vector<UInt8>	m_paramSlots;		// var idx -> param index (kNoParamSlot if not a param), see GetParamVars
+	UInt8				m_numParamSlots = 0;
+	UInt8				m_flags = 0;		// UserFunctionFlags
+	std::unique_ptr<MemoizedResults> m_memoizedResults;	// only for pure functions
+
+	static constexpr UInt8 kNoParamSlot = 0xFF;
 
 	FunctionInfo() = default;
 	FunctionInfo(Script* script);
@@ -62,7 +112,14 @@ struct FunctionInfo
 	UserFunctionParam* GetParam(UInt32 paramIndex);
 	bool Execute(FunctionCaller& caller, FunctionContext* context);
 	[[nodiscard]] ScriptEventList* GetEventList() const { return m_eventList; }
+	ScriptEventList* AcquireEventList();
+	void ReleaseEventList(ScriptEventList* eventList);
 	UInt32 GetParamVarTypes(UInt8* out) const;	// returns count, if > 0 returns types as array
+	void GetParamVars(ScriptEventList* eventList, ScriptLocal* (&paramVars)[kMaxUdfParams]) const;	// nullptr for params without a variable
+	[[nodiscard]] bool IsPure() const { return m_flags & kUserFunctionFlag_Pure; }
+	[[nodiscard]] MemoizedResults* GetMemoizedResults() const { return m_memoizedResults.get(); }
+	// false if an argument can't be keyed, in which case the call isn't cached
+	bool MakeMemoKey(ScriptEventList* eventList, TESObjectREFR* thisObj, TESObjectREFR* containingObj, std::string& key) const;
 };
 
 // represents a function executing on the stack
@@ -80,8 +137,9 @@ public:
 	FunctionContext(FunctionInfo* info, UInt8 version, Script* invokingScript);
 	~FunctionContext();
 
-	bool Execute(FunctionCaller& caller) const;
+	bool Execute(FunctionCaller& caller);
 	bool Return(ExpressionEvaluator* eval);
+	void Reset();	// readies the context for another call, as if it had been destroyed and recreated
 	[[nodiscard]] bool IsGood() const { return !m_bad; }
 	[[nodiscard]] ScriptToken* Result() const { return m_result.get(); }
 	[[nodiscard]] FunctionInfo* Info() const { return m_info; }
@@ -95,6 +153,8 @@ public:
 // Function args in Call bytecode. FunctionInfo encoded in Begin Function data. Return value from SetFunctionValue.
 class UserFunctionManager
 {
+	friend class UserFunctionBatch;
+
 	static UserFunctionManager* GetSingleton();
 
 	UserFunctionManager();
@@ -126,6 +186,31 @@ public:
 	static Script* GetInvokingScript(Script* fnScript);
 
 	static void ClearInfos();
+
+	// memoized results of pure functions; funcScript nullptr for all of them
+	static void ClearMemoizedResults(Script* funcScript);
+	static MemoizedStats GetMemoizedStats(Script* funcScript);
+};
+
+// calls one function script many times in a row (ar_ForEach, ar_MapTo, plugin batches), looking up its FunctionInfo
+// and creating its FunctionContext once per batch instead of once per call
+class UserFunctionBatch
+{
+	Script* m_script;
+	FunctionInfo* m_info = nullptr;
+	FunctionContext* m_context = nullptr;
+	UInt32 m_numCalls = 0;
+public:
+	UserFunctionBatch(Script* funcScript, Script* invokingScript = nullptr);
+	~UserFunctionBatch();
+	UserFunctionBatch(const UserFunctionBatch&) = delete;
+	UserFunctionBatch& operator=(const UserFunctionBatch&) = delete;
+
+	[[nodiscard]] bool IsGood() const { return m_context != nullptr; }
+	// returns false if the function could not be run; caller's ReadCallerVersion/ReadScript are not used
+	bool Call(FunctionCaller& caller);
+	// return value of the last call, owned by the batch and valid until the next call
+	[[nodiscard]] ScriptToken* Result() const { return m_context ? m_context->Result() : nullptr; }
 };
 
 // allows us to call function scripts directly
@@ -206,6 +291,9 @@ namespace PluginAPI {
 		NVSEArrayVarInterface::Element* result, UInt8 numArgs, ...);
 
 	bool CallFunctionScriptAlt(Script* fnScript, TESObjectREFR* callingObj, UInt8 numArgs, ...);
+
+	UInt32 CallFunctionScriptBatch(Script* fnScript, TESObjectREFR* callingObj, TESObjectREFR* container,
+		UInt8 numArgs, void* const* args, UInt32 numCalls, NVSEArrayVarInterface::Element* results);
 }
 
 #endif
\ No newline at end of file
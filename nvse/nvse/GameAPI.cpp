@@ -71,6 +71,7 @@ const _CreateFormInstance CreateFormInstance = (_CreateFormInstance)0x00465110;
 
 const _GetSingleton ConsoleManager_GetSingleton = (_GetSingleton)0x0071B160;
 bool *bEchoConsole = (bool *)0x011F158C;
+bool *bConsoleOpen = (bool *)0x011DEA2E;
 
 const _QueueUIMessage QueueUIMessage = (_QueueUIMessage)0x007052F0; // Called from Cmd_AddSpell_Execute
 
@@ -627,7 +628,7 @@ bool DefaultCommandParseHook(UInt16 numParams, ParamInfo *paramInfo, ScriptLineB
 					if (!IsStringFloat(spToken.tokenString))
 						goto compileError;
 					*pDataBuf++ = 'z';
-					*(double *)pDataBuf = atof(spToken.tokenString);
+					*(double *)pDataBuf = StrToDbl(spToken.tokenString);
 					pDataBuf += 8;
 				}
 				break;
@@ -781,10 +782,15 @@ static TLSData *GetTLSData()
 	return data;
 }
 
+bool IsConsoleOpen()
+{
+	return *bConsoleOpen != 0;
+}
+
 __declspec(naked) bool IsConsoleMode()
 {
 	__asm {
-		mov		al, byte ptr ds:[0x11DEA2E]
+		mov		al, byte ptr ds:[0x11DEA2E]	// bConsoleOpen
 		test	al, al
 		jz		done
 		mov		eax, dword ptr ds:[0x126FD98]
@@ -848,12 +854,107 @@ UInt32 s_CheckInsideOnActorEquipHook = 1;
 extern bool s_recordedMainThreadID;
 #endif
 
+#if NVSE_CORE
+namespace ConsolePrintQueue
+{
+	ICriticalSection s_cs;
+	std::string s_pending;		// each line is its echo flag, its text and a null
+	std::string s_flushing;
+	UInt32 s_linesPerFrame = 0x200;
+	bool s_logWhenClosed = false;
+	UInt32 s_overflowCount = 0;
+
+	static void Push(const char *fmt, va_list args)
+	{
+		char line[0x400];
+		const int length = vsnprintf(line, sizeof(line), fmt, args);
+		if (length < 0)
+			return;
+		ScopedLock lock(s_cs);
+		// the echo setting is applied as it was when the line was printed
+		s_pending += GetConsoleEcho() ? '\1' : '\0';
+		s_pending.append(line, length < sizeof(line) ? length : sizeof(line) - 1);
+		s_pending += '\0';
+	}
+
+	static void PrintToConsole(ConsoleManager *mgr, const char *fmt, ...)
+	{
+		va_list args;
+		va_start(args, fmt);
+		CALL_MEMBER_FN(mgr, Print)(fmt, args);
+		va_end(args);
+	}
+
+	void Flush()
+	{
+		{
+			ScopedLock lock(s_cs);
+			if (s_pending.empty())
+				return;
+			// printing may end up queueing more lines, those go out next frame
+			s_flushing.swap(s_pending);
+		}
+
+		ConsoleManager *mgr = ConsoleManager::GetSingleton();
+		const bool consoleClosed = !IsConsoleOpen();
+		const bool echo = GetConsoleEcho();
+		UInt32 numPrinted = 0, numOverflow = 0;
+		for (const char *line = s_flushing.data(), *end = line + s_flushing.size(); line != end; )
+		{
+			const bool lineEcho = *line++ != 0;
+			const UInt32 length = StrLen(line);
+			if (!mgr || (s_logWhenClosed && consoleClosed))
+				_MESSAGE("%s", line);
+			else if (s_linesPerFrame && numPrinted >= s_linesPerFrame)
+			{
+				_MESSAGE("%s", line);
+				numOverflow++;
+			}
+			else
+			{
+				SetConsoleEcho(lineEcho);
+				PrintToConsole(mgr, "%s", line);
+				numPrinted++;
+			}
+			line += length + 1;
+		}
+		SetConsoleEcho(echo);
+		s_flushing.clear();
+
+		if (numOverflow)
+		{
+			s_overflowCount += numOverflow;
+			PrintToConsole(mgr, "... %d more lines this frame were written to nvse.log", numOverflow);
+		}
+	}
+
+	void SetLinesPerFrame(UInt32 lines)
+	{
+		s_linesPerFrame = lines;
+	}
+
+	void SetLogWhenClosed(bool logWhenClosed)
+	{
+		s_logWhenClosed = logWhenClosed;
+	}
+
+	UInt32 GetOverflowCount()
+	{
+		return s_overflowCount;
+	}
+}
+#endif
+
 void Console_Print(const char *fmt, ...)
 {
 #if NVSE_CORE
 	if (!s_recordedMainThreadID)
 		return;
-#endif
+	va_list args;
+	va_start(args, fmt);
+	ConsolePrintQueue::Push(fmt, args);
+	va_end(args);
+#else
 	//if (!s_CheckInsideOnActorEquipHook || !s_InsideOnActorEquipHook) {
 	ConsoleManager *mgr = ConsoleManager::GetSingleton();
 	if (mgr)
@@ -868,6 +969,7 @@ void Console_Print(const char *fmt, ...)
 		va_end(args);
 	}
 	//}
+#endif
 }
 
 TESSaveLoadGame *TESSaveLoadGame::Get()
@@ -1920,6 +2022,71 @@ ScriptLocal *ScriptEventList::GetVariable(UInt32 id)
 	});
 }
 
+// Per-thread, direct-mapped tables of var id -> ScriptLocal for recently accessed event lists.
+// A table stays valid for as long as its event list lives. Each slot has a global stamp, deleting an event list bumps
+// only the stamp of the slot it maps to, so the tables of lists that are still alive survive UDF and lambda calls;
+// loading a game bumps them all.
+namespace
+{
+	struct ScriptLocalIndex
+	{
+		ScriptEventList *eventList = nullptr;
+		int stamp = 0;
+		Vector<ScriptLocal*> slots;
+	};
+
+	constexpr UInt32 kNumScriptLocalIndexes = 8;
+	constexpr UInt32 kMaxIndexedVarId = 0x1000;
+
+	std::atomic<int> s_scriptLocalIndexStamps[kNumScriptLocalIndexes] = {};
+	thread_local ScriptLocalIndex tls_scriptLocalIndexes[kNumScriptLocalIndexes];
+
+	UInt32 ScriptLocalIndexSlot(const ScriptEventList *eventList)
+	{
+		return (reinterpret_cast<UInt32>(eventList) >> 4) % kNumScriptLocalIndexes;
+	}
+}
+
+ScriptLocal *ScriptEventList::GetVariableIndexed(UInt32 id)
+{
+	const UInt32 slot = ScriptLocalIndexSlot(this);
+	auto &index = tls_scriptLocalIndexes[slot];
+	const int stamp = s_scriptLocalIndexStamps[slot];
+	if (index.eventList != this || index.stamp != stamp)
+	{
+		index.eventList = this;
+		index.stamp = stamp;
+		index.slots.Clear();
+		for (auto *var : *m_vars)
+		{
+			if (!var || var->id >= kMaxIndexedVarId)
+				continue;
+			if (var->id >= index.slots.Size())
+				index.slots.Resize(var->id + 1);
+			if (!index.slots[var->id]) // keep first match, same as GetVariable
+				index.slots[var->id] = var;
+		}
+	}
+	if (id < index.slots.Size())
+	{
+		if (auto *var = index.slots[id])
+			return var;
+	}
+	// not indexed (out of range, or appended to the list after the table was built)
+	return GetVariable(id);
+}
+
+void ScriptEventList::InvalidateVariableIndex(const ScriptEventList *eventList)
+{
+	++s_scriptLocalIndexStamps[ScriptLocalIndexSlot(eventList)];
+}
+
+void ScriptEventList::InvalidateVariableIndexes()
+{
+	for (auto &stamp : s_scriptLocalIndexStamps)
+		++stamp;
+}
+
 ScriptEventList *EventListFromForm(TESForm *form)
 {
 	ScriptEventList *eventList = NULL;
@@ -1992,232 +2159,491 @@ static void SkipArgs(UInt8 *&scriptData)
 	}
 }
 
-//static bool ExtractFormattedString(UInt32 &numArgs, char* buffer, UInt8* &scriptData, Script* scriptObj, ScriptEventList* eventList)
-bool ExtractFormattedString(FormatStringArgs &args, char *buffer)
+static constexpr UInt32 kMaxFormatArgs = 20;
+
+struct FormatStringOutput
 {
-	//extracts args based on format string, prints formatted string to buffer
-	static const int maxArgs = 20;
-	double f[maxArgs], data;
-	UInt32 argIdx = 0;
-	bool noArgFormat = false;
-	char fmtBuffer[0x4000];
+	char	*resPtr;
+	double	f[kMaxFormatArgs];
+	UInt32	argIdx = 0;
+	bool	noArgFormat = false;
 
-	char *resPtr = fmtBuffer, *srcPtr = args.GetFormatString(), *fmtPos, *strPtr, *omitEndPtr;
-	int size;
+	FormatStringOutput(char *outBuffer) : resPtr(outBuffer) {}
+};
+
+// emits a single specifier, extra holds the pronoun type for %p or the digit count for %x
+// %{ is handled by the callers since it needs to look ahead in the format string
+static bool EmitFormatSpecifier(FormatStringArgs &args, FormatStringOutput &out, char spec, char extra)
+{
+	double data;
 	TESForm *form;
+	char *resPtr = out.resPtr, *strPtr;
 
-	//extract args
-	while (fmtPos = strchr(srcPtr, '%'))
+	switch (spec)
 	{
-		size = fmtPos - srcPtr;
-		if (size)
-		{
-			memcpy(resPtr, srcPtr, size);
-			resPtr += size;
-		}
-		fmtPos++;
+	case '%': //literal %
+		*(UInt16 *)resPtr = '%%';
+		resPtr += 2;
+		out.noArgFormat = true;
+		break;
+	case 'z':
+	case 'Z': //string variable
+	{
+		if (!args.Arg(args.kArgType_Float, &data))
+			return false;
 
-		switch (*fmtPos)
-		{
-		case '%': //literal %
-			*(UInt16 *)resPtr = '%%';
-			resPtr += 2;
-			noArgFormat = true;
-			break;
-		case 'z':
-		case 'Z': //string variable
-		{
-			if (!args.Arg(args.kArgType_Float, &data))
-				return false;
+		strPtr = const_cast<char *>(StringFromStringVar(data));
+		if (strPtr && *strPtr)
+			resPtr = StrCopy(resPtr, strPtr);
+		break;
+	}
+	case 'r': //newline
+	case 'R':
+		*resPtr++ = '\n';
+		break;
+	case 'e':
+	case 'E': //workaround for CS not accepting empty strings
+		break;
+	case 'a':
+	case 'A': //character specified by ASCII code
+	{
+		if (args.Arg(args.kArgType_Float, &data))
+			*resPtr++ = (char)data;
+		else
+			return false;
+		break;
+	}
+	case 'n': // name of obj/ref
+	case 'N':
+	{
+		if (!args.Arg(args.kArgType_Form, &form))
+			return false;
 
-			strPtr = const_cast<char *>(StringFromStringVar(data));
-			if (strPtr && *strPtr)
-				resPtr = StrCopy(resPtr, strPtr);
-			break;
-		}
-		case 'r': //newline
-		case 'R':
-			*resPtr++ = '\n';
-			break;
-		case 'e':
-		case 'E': //workaround for CS not accepting empty strings
-			break;
-		case 'a':
-		case 'A': //character specified by ASCII code
-		{
-			if (args.Arg(args.kArgType_Float, &data))
-				*resPtr++ = (char)data;
-			else
-				return false;
-			break;
-		}
-		case 'n': // name of obj/ref
-		case 'N':
-		{
-			if (!args.Arg(args.kArgType_Form, &form))
-				return false;
+		StrCopy(resPtr, GetFullName(form));
+		resPtr = ConvertLiteralPercents(resPtr);
+		break;
+	}
+	case 'i': //formID
+	case 'I':
+	{
+		if (!args.Arg(args.kArgType_Form, &form))
+			return false;
 
-			StrCopy(resPtr, GetFullName(form));
-			resPtr = ConvertLiteralPercents(resPtr);
-			break;
-		}
-		case 'i': //formID
-		case 'I':
-		{
-			if (!args.Arg(args.kArgType_Form, &form))
-				return false;
+		resPtr += sprintf_s(resPtr, 9, "%08X", form ? form->refID : 0);
+		break;
+	}
+	case 'c': //named component of another object
+	case 'C': //2 args - object and index
+	{
+		if (!args.Arg(args.kArgType_Form, &form))
+			return false;
 
-			resPtr += sprintf_s(resPtr, 9, "%08X", form ? form->refID : 0);
-			break;
-		}
-		case 'c': //named component of another object
-		case 'C': //2 args - object and index
+		if (form)
 		{
-			if (!args.Arg(args.kArgType_Form, &form))
+			if (!args.Arg(args.kArgType_Float, &data))
 				return false;
-
-			if (form)
+			else
 			{
-				if (!args.Arg(args.kArgType_Float, &data))
-					return false;
-				else
+				switch (form->typeID)
 				{
-					switch (form->typeID)
-					{
-					case kFormType_TESAmmo:
+				case kFormType_TESAmmo:
+				{
+					switch ((int)data)
 					{
-						switch ((int)data)
-						{
-						default:
-						case 0: // full name
-							StrCopy(resPtr, GetFullName(form));
-							break;
-						case 1: // short name
-							StrCopy(resPtr, ((TESAmmo *)form)->shortName.CStr());
-							break;
-						case 2: // abbrev
-							StrCopy(resPtr, ((TESAmmo *)form)->abbreviation.CStr());
-							break;
-						}
-						resPtr = ConvertLiteralPercents(resPtr);
+					default:
+					case 0: // full name
+						StrCopy(resPtr, GetFullName(form));
 						break;
-					}
-					case kFormType_TESFaction:
-					{
-						StrCopy(resPtr, ((TESFaction *)form)->GetNthRankName(data));
-						resPtr = ConvertLiteralPercents(resPtr);
+					case 1: // short name
+						StrCopy(resPtr, ((TESAmmo *)form)->shortName.CStr());
+						break;
+					case 2: // abbrev
+						StrCopy(resPtr, ((TESAmmo *)form)->abbreviation.CStr());
 						break;
 					}
-					}
+					resPtr = ConvertLiteralPercents(resPtr);
+					break;
+				}
+				case kFormType_TESFaction:
+				{
+					StrCopy(resPtr, ((TESFaction *)form)->GetNthRankName(data));
+					resPtr = ConvertLiteralPercents(resPtr);
+					break;
+				}
 				}
 			}
-			break;
 		}
-		case 'k':
-		case 'K': //DX code
-		{
-			if (!args.Arg(args.kArgType_Float, &data))
-				return false;
+		break;
+	}
+	case 'k':
+	case 'K': //DX code
+	{
+		if (!args.Arg(args.kArgType_Float, &data))
+			return false;
 
-			resPtr = StrCopy(resPtr, GetDXDescription(data));
-			break;
-		}
-		case 'v':
-		case 'V': //actor value
-		{
-			if (!args.Arg(args.kArgType_Float, &data))
-				return false;
+		resPtr = StrCopy(resPtr, GetDXDescription(data));
+		break;
+	}
+	case 'v':
+	case 'V': //actor value
+	{
+		if (!args.Arg(args.kArgType_Float, &data))
+			return false;
 
-			resPtr = StrCopy(resPtr, GetActorValueString(data));
-			break;
-		}
-		case 'p':
-		case 'P': //pronouns
-		{
-			fmtPos++;
-			if (!args.Arg(args.kArgType_Form, &form))
-				return false;
+		resPtr = StrCopy(resPtr, GetActorValueString(data));
+		break;
+	}
+	case 'p':
+	case 'P': //pronouns
+	{
+		if (!args.Arg(args.kArgType_Form, &form))
+			return false;
 
-			if (form)
-			{
-				if (form->GetIsReference())
-					form = ((TESObjectREFR *)form)->baseForm;
+		if (form)
+		{
+			if (form->GetIsReference())
+				form = ((TESObjectREFR *)form)->baseForm;
 
-				UInt8 objType = 0;
-				if (form->typeID == kFormType_TESNPC)
-					objType = ((TESNPC *)form)->baseData.IsFemale() ? 2 : 1;
+			UInt8 objType = 0;
+			if (form->typeID == kFormType_TESNPC)
+				objType = ((TESNPC *)form)->baseData.IsFemale() ? 2 : 1;
 
-				switch (*fmtPos)
-				{
-				case 'o':
-				case 'O':
+			switch (extra)
+			{
+			case 'o':
+			case 'O':
+			{
+				switch (objType)
 				{
-					switch (objType)
-					{
-					default:
-					case 0:
-						*(UInt16 *)resPtr = 'ti';
-						resPtr += 2;
-						break;
-					case 1:
-						*(UInt32 *)resPtr = '\0mih';
-						resPtr += 3;
-						break;
-					case 2:
-						*(UInt32 *)resPtr = '\0reh';
-						resPtr += 3;
-						break;
-					}
+				default:
+				case 0:
+					*(UInt16 *)resPtr = 'ti';
+					resPtr += 2;
 					break;
-				}
-				case 's':
-				case 'S':
-				{
-					switch (objType)
-					{
-					default:
-					case 0:
-						*(UInt16 *)resPtr = 'ti';
-						resPtr += 2;
-						break;
-					case 1:
-						*(UInt16 *)resPtr = 'eh';
-						resPtr += 2;
-						break;
-					case 2:
-						*(UInt32 *)resPtr = '\0ehs';
-						resPtr += 3;
-						break;
-					}
+				case 1:
+					*(UInt32 *)resPtr = '\0mih';
+					resPtr += 3;
+					break;
+				case 2:
+					*(UInt32 *)resPtr = '\0reh';
+					resPtr += 3;
 					break;
 				}
-				case 'p':
-				case 'P':
+				break;
+			}
+			case 's':
+			case 'S':
+			{
+				switch (objType)
 				{
-					switch (objType)
-					{
-					default:
-					case 0:
-						*(UInt32 *)resPtr = '\0sti';
-						break;
-					case 1:
-						*(UInt32 *)resPtr = '\0sih';
-						break;
-					case 2:
-						*(UInt32 *)resPtr = '\0reh';
-						break;
-					}
+				default:
+				case 0:
+					*(UInt16 *)resPtr = 'ti';
+					resPtr += 2;
+					break;
+				case 1:
+					*(UInt16 *)resPtr = 'eh';
+					resPtr += 2;
+					break;
+				case 2:
+					*(UInt32 *)resPtr = '\0ehs';
 					resPtr += 3;
 					break;
 				}
+				break;
+			}
+			case 'p':
+			case 'P':
+			{
+				switch (objType)
+				{
+				default:
+				case 0:
+					*(UInt32 *)resPtr = '\0sti';
+					break;
+				case 1:
+					*(UInt32 *)resPtr = '\0sih';
+					break;
+				case 2:
+					*(UInt32 *)resPtr = '\0reh';
+					break;
 				}
+				resPtr += 3;
+				break;
+			}
 			}
-			break;
 		}
-		case 'q':
-		case 'Q': //double quote
-			*resPtr++ = '\"';
+		break;
+	}
+	case 'q':
+	case 'Q': //double quote
+		*resPtr++ = '\"';
+		break;
+	case '}': //in case someone left a stray closing bracket
+		break;
+	case 'x': //hex
+	case 'X':
+	{
+		if (!args.Arg(args.kArgType_Float, &data))
+			return false;
+
+		*(UInt64 *)(&out.f[out.argIdx++]) = data;
+		*(UInt16 *)resPtr = '0%';
+		resPtr += 2;
+		if (extra)
+			*resPtr++ = extra;
+		*(UInt32 *)resPtr = '\0Xll';
+		resPtr += 3;
+		break;
+	}
+	default: //float
+	{
+		if (!args.Arg(args.kArgType_Float, &data))
+			return false;
+
+		out.f[out.argIdx++] = data;
+		*resPtr++ = '%';
+		*resPtr++ = spec;
+		break;
+	}
+	}
+
+	out.resPtr = resPtr;
+	return true;
+}
+
+// number of args consumed by a specifier inside an omitted %{ ... %} section
+static UInt32 GetOmittedSpecifierArgs(char spec)
+{
+	switch (spec)
+	{
+	case '%':
+	case 'q':
+	case 'Q':
+	case 'r':
+	case 'R':
+		return 0;
+	case 'c':
+	case 'C':
+		return 2;
+	default:
+		return 1;
+	}
+}
+
+// specifiers that leave a printf directive in the output and so need the snprintf pass
+static bool FormatSpecifierNeedsPrintf(char spec)
+{
+	switch (spec)
+	{
+	case 'z': case 'Z': case 'r': case 'R': case 'e': case 'E': case 'a': case 'A':
+	case 'n': case 'N': case 'i': case 'I': case 'c': case 'C': case 'k': case 'K':
+	case 'v': case 'V': case 'p': case 'P': case 'q': case 'Q': case '{': case '}':
+		return false;
+	default:
+		return true;
+	}
+}
+
+static void FinishFormattedString(char *buffer, char *fmtBuffer, FormatStringOutput &out)
+{
+	*out.resPtr = 0;
+
+	if (fmtBuffer[0])
+	{
+		if (out.argIdx || out.noArgFormat)
+		{
+			const double *f = out.f;
+			snprintf(buffer, kMaxMessageLength - 2, fmtBuffer, f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7], f[8], f[9], f[10], f[11], f[12], f[13], f[14], f[15], f[16], f[17], f[18], f[19]);
+		}
+		else
+			memcpy(buffer, fmtBuffer, (out.resPtr - fmtBuffer) + 1);
+	}
+	else
+		*buffer = 0;
+}
+
+// Parsed form of a format string, cached per script location so repeated calls only fetch args and emit output.
+// The source text is kept to validate the plan, since the key (a pointer into script data or a string token) can be reused.
+struct FormatPlan
+{
+	static constexpr UInt32 kNoOmitEnd = 0xFFFFFFFF;
+
+	struct Op
+	{
+		UInt32	pct;		// offset of the '%'
+		UInt32	next;		// offset of the text following the specifier
+		UInt32	omitEnd;	// for %{, index of the op for the matching %}
+		char	spec;
+		char	extra;
+	};
+
+	std::string	text;
+	Vector<Op>	ops;
+	bool		irregular = false;	// constructs the plan can't reproduce exactly, interpreted by ExtractFormattedStringLegacy
+	bool		needsPrintf = false;
+
+	void Build(const char *fmtString);
+	bool Run(FormatStringArgs &args, FormatStringOutput &out) const;
+};
+
+void FormatPlan::Build(const char *fmtString)
+{
+	text = fmtString;
+	ops.Clear();
+	irregular = false;
+	needsPrintf = false;
+
+	const char *src = text.c_str();
+	const char *pctPtr = src;
+	while ((pctPtr = strchr(pctPtr, '%')))
+	{
+		Op op{UInt32(pctPtr - src), UInt32(pctPtr - src) + 2, kNoOmitEnd, pctPtr[1], 0};
+		switch (op.spec)
+		{
+		case 0: // trailing '%'
+			irregular = true;
+			return;
+		case 'p':
+		case 'P':
+			op.extra = pctPtr[2];
+			// a '%' here would be consumed as the pronoun type but not when skipping an omitted section
+			if (!op.extra || op.extra == '%')
+			{
+				irregular = true;
+				return;
+			}
+			op.next++;
+			break;
+		case 'x':
+		case 'X':
+			if ((pctPtr[2] >= '0') && (pctPtr[2] <= '9'))
+			{
+				op.extra = pctPtr[2];
+				op.next++;
+			}
 			break;
+		case '{':
+			// resolved to an op index below
+			if (const char *omitEndPtr = strstr(pctPtr + 2, "%}"))
+				op.omitEnd = omitEndPtr - src;
+			break;
+		}
+		needsPrintf |= FormatSpecifierNeedsPrintf(op.spec);
+		ops.Append(op);
+		pctPtr = src + op.next;
+	}
+
+	// %} must line up with the start of a specifier for the omitted args to be counted the same way as the legacy scan
+	Op *opsBegin = ops.Data(), *opsEnd = opsBegin + ops.Size();
+	for (Op *op = opsBegin; op != opsEnd; ++op)
+	{
+		if ((op->spec != '{') || (op->omitEnd == kNoOmitEnd))
+			continue;
+		Op *endOp = op + 1;
+		while ((endOp != opsEnd) && (endOp->pct < op->omitEnd))
+			++endOp;
+		if ((endOp == opsEnd) || (endOp->pct != op->omitEnd))
+		{
+			irregular = true;
+			return;
+		}
+		op->omitEnd = endOp - opsBegin;
+	}
+}
+
+bool FormatPlan::Run(FormatStringArgs &args, FormatStringOutput &out) const
+{
+	const char *src = text.c_str();
+	const Op *opsData = ops.Data();
+	UInt32 srcPos = 0, size;
+	double data;
+
+	for (UInt32 idx = 0, numOps = ops.Size(); idx < numOps; idx++)
+	{
+		const Op &op = opsData[idx];
+		if (size = op.pct - srcPos)
+		{
+			memcpy(out.resPtr, src + srcPos, size);
+			out.resPtr += size;
+		}
+		srcPos = op.next;
+
+		if (op.spec != '{')
+		{
+			if (!EmitFormatSpecifier(args, out, op.spec, op.extra))
+				return false;
+			continue;
+		}
+		if (op.omitEnd == kNoOmitEnd)
+			continue;
+
+		if (!args.Arg(args.kArgType_Float, &data))
+			return false;
+		// when shown, the matching %} is a no-op
+		if (data)
+			continue;
+
+		for (UInt32 skipIdx = idx + 1; (skipIdx < op.omitEnd) && args.HasMoreArgs(); skipIdx++)
+		{
+			if (UInt32 numToSkip = GetOmittedSpecifierArgs(opsData[skipIdx].spec))
+				args.SkipArgs(numToSkip);
+		}
+		idx = op.omitEnd;
+		srcPos = opsData[idx].next;
+	}
+
+	if (size = text.size() - srcPos)
+	{
+		memcpy(out.resPtr, src + srcPos, size);
+		out.resPtr += size;
+	}
+	return true;
+}
+
+static constexpr UInt32 kMaxFormatPlans = 0x1000;
+static thread_local UnorderedMap<const UInt8*, FormatPlan> s_formatPlans;
+
+static const FormatPlan *GetFormatPlan(const void *planKey, const char *fmtString)
+{
+	FormatPlan *plan = s_formatPlans.GetPtr(static_cast<const UInt8 *>(planKey));
+	if (!plan)
+	{
+		if (s_formatPlans.Size() >= kMaxFormatPlans)
+			s_formatPlans.Clear();
+		plan = &s_formatPlans[static_cast<const UInt8 *>(planKey)];
+		plan->Build(fmtString);
+	}
+	else if (strcmp(plan->text.c_str(), fmtString))
+		plan->Build(fmtString);
+	return plan;
+}
+
+static bool ExtractFormattedStringLegacy(FormatStringArgs &args, char *buffer)
+{
+	//extracts args based on format string, prints formatted string to buffer
+	char fmtBuffer[0x4000];
+	FormatStringOutput out(fmtBuffer);
+
+	char *srcPtr = args.GetFormatString(), *fmtPos, *strPtr, *omitEndPtr;
+	int size;
+	double data;
+
+	//extract args
+	while (fmtPos = strchr(srcPtr, '%'))
+	{
+		size = fmtPos - srcPtr;
+		if (size)
+		{
+			memcpy(out.resPtr, srcPtr, size);
+			out.resPtr += size;
+		}
+		fmtPos++;
+
+		const char spec = *fmtPos;
+		char extra = 0;
+		switch (spec)
+		{
 		case '{': //omit portion of string based on flag param
 		{
 			omitEndPtr = strstr(fmtPos + 1, "%}");
@@ -2234,80 +2660,68 @@ bool ExtractFormattedString(FormatStringArgs &args, char *buffer)
 					while ((strPtr = strchr(fmtPos, '%')) && (strPtr < omitEndPtr) && args.HasMoreArgs())
 					{
 						strPtr++;
-						switch (*strPtr)
-						{
-						case '%':
-						case 'q':
-						case 'Q':
-						case 'r':
-						case 'R':
-							break;
-						case 'c':
-						case 'C':
-							args.SkipArgs(2);
-							break;
-						default:
-							args.SkipArgs(1);
-						}
+						if (UInt32 numToSkip = GetOmittedSpecifierArgs(*strPtr))
+							args.SkipArgs(numToSkip);
 						fmtPos = strPtr + 1;
 					}
 					fmtPos = omitEndPtr + 1;
 				}
 			}
-			break;
+			srcPtr = fmtPos + 1;
+			continue;
 		}
-		case '}': //in case someone left a stray closing bracket
+		case 'p':
+		case 'P':
+			extra = *++fmtPos;
 			break;
-		case 'x': //hex
+		case 'x':
 		case 'X':
-		{
-			if (!args.Arg(args.kArgType_Float, &data))
-				return false;
-
-			*(UInt64 *)(&f[argIdx++]) = data;
-			*(UInt16 *)resPtr = '0%';
-			resPtr += 2;
 			if ((fmtPos[1] >= '0') && (fmtPos[1] <= '9'))
-			{
-				*resPtr++ = fmtPos[1];
-				fmtPos++;
-			}
-			*(UInt32 *)resPtr = '\0Xll';
-			resPtr += 3;
+				extra = *++fmtPos;
 			break;
 		}
-		default: //float
-		{
-			if (!args.Arg(args.kArgType_Float, &data))
-				return false;
 
-			f[argIdx++] = data;
-			*resPtr++ = '%';
-			*resPtr++ = *fmtPos;
-			break;
-		}
-		}
+		if (!EmitFormatSpecifier(args, out, spec, extra))
+			return false;
 
 		srcPtr = fmtPos + 1;
 	}
 
 	if (size = StrLen(srcPtr))
 	{
-		memcpy(resPtr, srcPtr, size);
-		resPtr += size;
+		memcpy(out.resPtr, srcPtr, size);
+		out.resPtr += size;
 	}
-	*resPtr = 0;
 
-	if (fmtBuffer[0])
+	FinishFormattedString(buffer, fmtBuffer, out);
+	return true;
+}
+
+//static bool ExtractFormattedString(UInt32 &numArgs, char* buffer, UInt8* &scriptData, Script* scriptObj, ScriptEventList* eventList)
+bool ExtractFormattedString(FormatStringArgs &args, char *buffer, const void *planKey)
+{
+	if (!planKey)
+		return ExtractFormattedStringLegacy(args, buffer);
+
+	const FormatPlan *plan = GetFormatPlan(planKey, args.GetFormatString());
+	if (plan->irregular)
+		return ExtractFormattedStringLegacy(args, buffer);
+
+	if (!plan->needsPrintf)
 	{
-		if (argIdx || noArgFormat)
-			snprintf(buffer, kMaxMessageLength - 2, fmtBuffer, f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7], f[8], f[9], f[10], f[11], f[12], f[13], f[14], f[15], f[16], f[17], f[18], f[19]);
-		else
-			memcpy(buffer, fmtBuffer, (resPtr - fmtBuffer) + 1);
+		// nothing for snprintf to expand, emit straight into the result
+		FormatStringOutput out(buffer);
+		if (!plan->Run(args, out))
+			return false;
+		*out.resPtr = 0;
+		return true;
 	}
-	else
-		*buffer = 0;
 
+	char fmtBuffer[0x4000];
+	FormatStringOutput out(fmtBuffer);
+	if (!plan->Run(args, out))
+		return false;
+	FinishFormattedString(buffer, fmtBuffer, out);
 	return true;
 }
 
@@ -2357,7 +2771,7 @@ bool ExtractFormatStringArgs(UInt32 fmtStringPos, char *buffer, ParamInfo *param
 	ScriptFormatStringArgs scriptArgs(numArgs, scriptData, scriptObj, eventList, scriptDataIn);
 	if (scriptArgs.m_bad)
 		return false;
-	bExtracted = ExtractFormattedString(scriptArgs, buffer);
+	bExtracted = ExtractFormattedString(scriptArgs, buffer, scriptArgs.GetPlanKey());
 
 	numArgs = scriptArgs.GetNumArgs();
 	scriptData = scriptArgs.GetScriptData();
@@ -2465,6 +2879,8 @@ ScriptFormatStringArgs::ScriptFormatStringArgs(UInt32 _numArgs, UInt8 *_scriptDa
 	scriptData += 2;
 	memcpy(s_tempStrArgBuffer, scriptData, len);
 	s_tempStrArgBuffer[len] = 0;
+	if (s_tempStrArgBuffer[0] != '$')
+		planKey = scriptData;
 	scriptData += len;
 	if (s_tempStrArgBuffer[0] == '$')
 	{
@@ -2502,6 +2918,11 @@ UInt8 *ScriptFormatStringArgs::GetScriptData()
 	return scriptData;
 }
 
+const void *ScriptFormatStringArgs::GetPlanKey() const
+{
+	return planKey;
+}
+
 bool ScriptFormatStringArgs::SkipArgs(UInt32 numToSkip)
 {
 	while (numToSkip--)
@@ -31,6 +31,21 @@ extern UInt32 s_CheckInsideOnActorEquipHook;
 
 void Console_Print(const char *fmt, ...);
 
+#if NVSE_CORE
+// Console_Print lines are queued and handed to the game console once per frame, up to a set number of lines per frame.
+// Lines over that limit, and optionally all lines while the console is closed, go to nvse.log instead.
+namespace ConsolePrintQueue
+{
+	// called once per frame from the main loop
+	void Flush();
+	// 0 means no limit
+	void SetLinesPerFrame(UInt32 lines);
+	void SetLogWhenClosed(bool logWhenClosed);
+	// lines that went to the log for being over the per-frame limit
+	UInt32 GetOverflowCount();
+}
+#endif
+
 //typedef void * (* _FormHeap_Allocate)(UInt32 size);
 //extern const _FormHeap_Allocate FormHeap_Allocate;
 //
@@ -50,6 +65,7 @@ typedef TESForm *(*_CreateFormInstance)(UInt8 type);
 extern const _CreateFormInstance CreateFormInstance;
 
 bool IsConsoleMode();
+bool IsConsoleOpen();	// console menu is shown; IsConsoleMode also requires the running command to come from it
 bool GetConsoleEcho();
 void SetConsoleEcho(bool doEcho);
 const char *GetFullName(TESForm *baseForm);
@@ -197,8 +213,14 @@ struct ScriptEventList
 
 	void Dump(void);
 	ScriptLocal *GetVariable(UInt32 id);
+	ScriptLocal *GetVariableIndexed(UInt32 id); // O(1) after the first lookup on this list, falls back to GetVariable
 	UInt32 ResetAllVariables();
 	ScriptEventList *Copy();
+
+	// must be called before an event list is freed
+	static void InvalidateVariableIndex(const ScriptEventList *eventList);
+	// must be called whenever event lists are freed in bulk or their variables rebuilt
+	static void InvalidateVariableIndexes();
 };
 
 ScriptEventList *EventListFromForm(TESForm *form);
@@ -405,6 +427,7 @@ public:
 	ScriptFormatStringArgs(UInt32 _numArgs, UInt8 *_scriptData, Script *_scriptObj, ScriptEventList *_eventList, void *scriptDataIn);
 	UInt32 GetNumArgs();
 	UInt8 *GetScriptData();
+	const void *GetPlanKey() const; // location of a literal format string in script data, null otherwise
 	bool m_bad = false;
 
 private:
@@ -413,12 +436,14 @@ private:
 	Script *scriptObj;
 	ScriptEventList *eventList;
 	void *scriptDataIn;
+	const void *planKey = nullptr;
 };
 bool SCRIPT_ASSERT(bool expr, Script *script, const char *errorMsg, ...);
 
 bool ExtractSetStatementVar(Script *script, ScriptEventList *eventList, void *scriptDataIn, double *outVarData, bool *makeTemporary,
                             const UInt32 *opcodeOffsetPtr, UInt8 *outModIndex, TESObjectREFR* refr);
-bool ExtractFormattedString(FormatStringArgs &args, char *buffer);
+// planKey identifies the call site of an unchanging format string so its parsed form can be reused, null to always parse
+bool ExtractFormattedString(FormatStringArgs &args, char *buffer, const void *planKey = nullptr);
 
 class ChangesMap;
 class InteriorCellNewReferencesMap;
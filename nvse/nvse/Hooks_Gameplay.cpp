@@ -27,6 +27,7 @@
 
 #include "GameData.h"
 #include "UnitTests.h"
+#include "LambdaManager.h"
 
 static void HandleMainLoopHook(void);
 
@@ -60,52 +61,105 @@ bool RunCommand_NS(COMMAND_ARGS, Cmd_Execute cmd)
 }
 
 float g_gameSecondsPassed = 0;
+float g_gameModeSecondsPassed = 0;
+UInt32 g_mainLoopFrames = 0;
+
+// Walk over a list of per-frame calls under the deferred call budget.
+// Calls skipped for lack of time are rotated to the front of the list so they are the first to run next frame.
+template <typename T>
+class BudgetedListPass
+{
+	std::list<T>& m_infos;
+	typename std::list<T>::iterator m_firstDeferred;
+public:
+	explicit BudgetedListPass(std::list<T>& infos) : m_infos(infos), m_firstDeferred(infos.end()) {}
+
+	~BudgetedListPass()
+	{
+		if (m_firstDeferred != m_infos.end())
+			m_infos.splice(m_infos.end(), m_infos, m_infos.begin(), m_firstDeferred);
+	}
+
+	// returns true if the call has to wait for a later frame
+	bool Defer(typename std::list<T>::iterator iter)
+	{
+		if (iter->IsStrict() || DeferredCallBudget::HasTimeLeft())
+			return false;
+		if (m_firstDeferred == m_infos.end())
+		{
+			m_firstDeferred = iter;
+			DeferredCallBudget::NoteOverrun();
+		}
+		return true;
+	}
+};
 
 // xNVSE 6.1
-void HandleDelayedCall(float timeDelta, bool isMenuMode)
+void HandleDelayedCall()
 {
-	if (g_callAfterInfos.empty())
+	if (g_callAfterInfos.Empty())
 		return; // avoid lock overhead
 
 	ScopedLock lock(g_callAfterInfosCS);
 
-	auto iter = g_callAfterInfos.begin();
-	while (iter != g_callAfterInfos.end())
+	// due calls left over once the budget is spent stay in the queue, their earlier deadlines put them first next frame
+	while (auto info = g_callAfterInfos.PopDue(!DeferredCallBudget::HasTimeLeft()))
 	{
-		if (!iter->RunInMenuMode() && isMenuMode)
-		{
-			iter->time += timeDelta;
-		}
-		if (g_gameSecondsPassed >= iter->time)
-		{
-			ArrayElementArgFunctionCaller caller(iter->script, iter->args, iter->thisObj);
-			UserFunctionManager::Call(std::move(caller));
-			iter = g_callAfterInfos.erase(iter); // yes, this is valid: https://stackoverflow.com/a/3901380/6741772
-		}
-		else
+		ArrayElementArgFunctionCaller caller(info->script, info->args, info->thisObj);
+		UserFunctionManager::Call(std::move(caller));
+	}
+	if (g_callAfterInfos.HasDue())
+		DeferredCallBudget::NoteOverrun();
+}
+
+// Polls CallWhile/CallWhen conditions, entries sharing a condition script reuse one function context for the whole pass.
+// Lambda conditions aren't batched, a context captures the lambda's parent event list, which a callback between polls may reset or delete.
+class ConditionPoller
+{
+	std::unordered_map<Script*, std::unique_ptr<UserFunctionBatch>> m_batches;
+public:
+	bool Poll(const CallWhileInfo& info, bool passArgs)
+	{
+		DeferredCallBudget::NoteConditionCall();
+		ArrayElementArgFunctionCaller<SelfOwningArrayElement> conditionCaller(info.condition);
+		if (passArgs)
+			conditionCaller.SetArgs(info.args);
+
+		if (LambdaManager::IsScriptLambda(info.condition))
 		{
-			++iter;
+			const auto conditionResult = UserFunctionManager::Call(std::move(conditionCaller));
+			return conditionResult && conditionResult->GetBool();
 		}
+
+		auto& batch = m_batches[info.condition];
+		if (!batch)
+			batch = std::make_unique<UserFunctionBatch>(info.condition);
+		if (!batch->Call(conditionCaller))
+			return false;
+		const auto* conditionResult = batch->Result();
+		return conditionResult && conditionResult->GetBool();
 	}
-}
+};
 
 void HandleCallWhileScripts()
 {
 	if (g_callWhileInfos.empty())
 		return; // avoid lock overhead
 	ScopedLock lock(g_callWhileInfosCS);
+	BudgetedListPass pass(g_callWhileInfos);
+	ConditionPoller poller;
 
 	auto iter = g_callWhileInfos.begin();
 	while (iter != g_callWhileInfos.end())
 	{
-		ArrayElementArgFunctionCaller<SelfOwningArrayElement> conditionCaller(iter->condition);
-		if (iter->PassArgsToCondFunc())
+		if (!iter->IsPollDue() || pass.Defer(iter))
 		{
-			conditionCaller.SetArgs(iter->args);
+			++iter;
+			continue;
 		}
+		iter->ScheduleNextPoll();
 
-		if (auto const conditionResult = UserFunctionManager::Call(std::move(conditionCaller)); 
-			conditionResult && conditionResult->GetBool())
+		if (poller.Poll(*iter, iter->PassArgsToCondFunc()))
 		{
 			ArrayElementArgFunctionCaller<SelfOwningArrayElement> scriptCaller(iter->callFunction, iter->thisObj);
 			if (iter->PassArgsToCallFunc())
@@ -125,18 +179,21 @@ void HandleCallWhenScripts()
 	if (g_callWhenInfos.empty())
 		return; // avoid lock overhead
 	ScopedLock lock(g_callWhenInfosCS);
+	BudgetedListPass pass(g_callWhenInfos);
+	ConditionPoller poller;
 
 	auto iter = g_callWhenInfos.begin();
 	while (iter != g_callWhenInfos.end())
 	{
-		ArrayElementArgFunctionCaller conditionCaller(iter->condition, iter->args);
-		if (iter->PassArgsToCondFunc())
+		if (!iter->IsPollDue() || pass.Defer(iter))
 		{
-			conditionCaller.SetArgs(iter->args);
+			++iter;
+			continue;
 		}
+		iter->ScheduleNextPoll();
 
-		if (auto const conditionResult = UserFunctionManager::Call(std::move(conditionCaller)); 
-			conditionResult && conditionResult->GetBool())
+		// args have always been passed to CallWhen conditions
+		if (poller.Poll(*iter, true))
 		{
 			ArrayElementArgFunctionCaller<SelfOwningArrayElement> scriptCaller(iter->callFunction, iter->thisObj);
 			if (iter->PassArgsToCallFunc())
@@ -151,21 +208,23 @@ void HandleCallWhenScripts()
 	}
 }
 
-void HandleCallForScripts(float timeDelta, bool isMenuMode)
+void HandleCallForScripts()
 {
 	if (g_callForInfos.empty())
 		return; // avoid lock overhead
 	ScopedLock lock(g_callForInfosCS);
+	BudgetedListPass pass(g_callForInfos);
 
 	auto iter = g_callForInfos.begin();
 	while (iter != g_callForInfos.end())
 	{
-		if (!iter->RunInMenuMode() && isMenuMode)
-		{
-			iter->time += timeDelta;
-		}
-		if (g_gameSecondsPassed < iter->time)
+		if (GetDelayedCallClock(iter->flags) < iter->time)
 		{
+			if (pass.Defer(iter))
+			{
+				++iter;
+				continue;
+			}
 			ArrayElementArgFunctionCaller caller(iter->script, iter->args, iter->thisObj);
 			UserFunctionManager::Call(std::move(caller));
 			++iter;
@@ -249,6 +308,16 @@ static void HandleMainLoopHook(void)
 	{
 		DetermineShowScriptErrors();
 		ApplyGECKEditorIDs();
+		if (UInt32 budget; GetNVSEConfigOption_UInt32("RELEASE", "iDeferredCallBudgetMicroseconds", &budget))
+			DeferredCallBudget::SetBudget(budget);
+		if (UInt32 roundTrip; GetNVSEConfigOption_UInt32("RELEASE", "bRoundTripNumberStrings", &roundTrip))
+			g_roundTripNumberStrings = roundTrip != 0;
+		if (UInt32 repeatLimit; GetNVSEConfigOption_UInt32("RELEASE", "iRuntimeErrorRepeatLimit", &repeatLimit))
+			RuntimeErrorThrottle::SetRepeatLimit(repeatLimit);
+		if (UInt32 linesPerFrame; GetNVSEConfigOption_UInt32("RELEASE", "iConsoleLinesPerFrame", &linesPerFrame))
+			ConsolePrintQueue::SetLinesPerFrame(linesPerFrame);
+		if (UInt32 logWhenClosed; GetNVSEConfigOption_UInt32("RELEASE", "bConsolePrintToLogWhenClosed", &logWhenClosed))
+			ConsolePrintQueue::SetLogWhenClosed(logWhenClosed != 0);
 		s_recordedMainThreadID = true;
 #if ALPHA_MODE
 		Console_Print("xNVSE %d.%d.%d Beta Build %s", NVSE_VERSION_INTEGER, NVSE_VERSION_INTEGER_MINOR, NVSE_VERSION_INTEGER_BETA, __TIME__);
@@ -277,6 +346,10 @@ static void HandleMainLoopHook(void)
 	g_StringMap.Clean();
 	LambdaManager::EraseUnusedSavedVariableLists();
 
+	++g_mainLoopFrames;
+	DeferredCallBudget::BeginFrame();
+	RuntimeErrorThrottle::Update();
+
 	// handle calls from cmd CallWhile
 	HandleCallWhileScripts();
 	HandleCallWhenScripts();
@@ -285,14 +358,19 @@ static void HandleMainLoopHook(void)
 	const float timeDelta = g_timeGlobal->secondsPassed * static_cast<float>(vatsTimeMult);
 	const auto isMenuMode = CdeclCall<bool>(0x702360);
 	g_gameSecondsPassed += timeDelta;
+	if (!isMenuMode)
+		g_gameModeSecondsPassed += timeDelta;
 
 	// handle calls from cmd CallAfterSeconds
-	HandleDelayedCall(timeDelta, isMenuMode);
+	HandleDelayedCall();
 
 	// handle calls from cmd CallForSeconds
-	HandleCallForScripts(timeDelta, isMenuMode);
+	HandleCallForScripts();
 
+	DeferredCallBudget::EndFrame(g_callAfterInfos.Size() + g_callForInfos.size() + g_callWhileInfos.size() + g_callWhenInfos.size());
 
+	// hand this frame's Console_Print lines to the console in one go
+	ConsolePrintQueue::Flush();
 }
 
 #define DEBUG_PRINT_CHANNEL(idx)								\
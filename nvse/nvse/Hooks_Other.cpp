@@ -75,6 +75,7 @@ namespace OtherHooks
 		
 		LambdaManager::MarkParentAsDeleted(eventList); // deletes if exists
 		CleanUpNVSEVars(eventList);
+		ScriptEventList::InvalidateVariableIndex(eventList);
 		ThisStdCall(0x5A8BC0, eventList);
 		FormHeap_Free(eventList);
 	}
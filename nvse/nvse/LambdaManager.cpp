@@ -27,14 +27,18 @@ struct VariableListContext
 	std::unique_ptr<TempObject<Script, false>> scriptCopy = nullptr;
 };
 
+// script data position and owner of the lambda's definition
+using LambdaPosKey = std::pair<UInt8*, FormID>;
+
 // used for memoizing scripts and prevent endless allocation of scripts
-static std::map<std::pair<UInt8*, FormID>, ScriptLambda*> g_lambdaScriptPosMap;
+static std::map<LambdaPosKey, ScriptLambda*> g_lambdaScriptPosMap;
 std::unordered_map<ScriptEventList*, VariableListContext> g_savedVarLists;
 
 struct LambdaContext
 {
+	LambdaPosKey posKey{};
 	Script* parentScript = nullptr;
-	ScriptEventList* parentEventList = nullptr;
+	ScriptEventList* parentEventList = nullptr;	// only set through SetLambdaParent
 	// any lambdas that are referenced within this lambda
 	std::optional<std::vector<ScriptLambda*>> capturedLambdaVariableScripts;
 	std::unordered_set<ScriptLambda*> lambdaParents;
@@ -48,6 +52,10 @@ struct LambdaContext
 // contains all lambdas
 static std::unordered_map<ScriptLambda*, LambdaContext> g_lambdas;
 
+// reverse indexes of g_lambdas, see SetLambdaParent and EraseLambda
+static std::unordered_map<ScriptEventList*, std::unordered_set<ScriptLambda*>> g_lambdasByParentEventList;
+static std::unordered_map<Script*, std::unordered_set<ScriptLambda*>> g_lambdasByParentScript;
+
 // avoid concurrency issues
 ICriticalSection LambdaManager::g_lambdaCs;
 
@@ -58,14 +66,42 @@ LambdaContext* GetLambdaContext(ScriptLambda* scriptLambda)
 	return nullptr;
 }
 
-void SetLambdaParent(LambdaContext& ctx, ScriptEventList* parentEventList)
+template <typename K>
+void EraseFromIndex(std::unordered_map<K, std::unordered_set<ScriptLambda*>>& index, K key, ScriptLambda* scriptLambda)
+{
+	if (const auto iter = index.find(key); iter != index.end())
+	{
+		iter->second.erase(scriptLambda);
+		if (iter->second.empty())
+			index.erase(iter);
+	}
+}
+
+void SetLambdaParent(ScriptLambda* scriptLambda, LambdaContext& ctx, ScriptEventList* parentEventList)
 {
+	if (ctx.parentEventList == parentEventList)
+		return;
+	if (ctx.parentEventList)
+		EraseFromIndex(g_lambdasByParentEventList, ctx.parentEventList, scriptLambda);
 	ctx.parentEventList = parentEventList;
+	if (parentEventList)
+		g_lambdasByParentEventList[parentEventList].insert(scriptLambda);
 }
 
 void SetLambdaParent(ScriptLambda* scriptLambda, ScriptEventList* parentEventList)
 {
-	SetLambdaParent(g_lambdas[scriptLambda], parentEventList);
+	SetLambdaParent(scriptLambda, g_lambdas[scriptLambda], parentEventList);
+}
+
+void EraseLambda(std::unordered_map<ScriptLambda*, LambdaContext>::iterator iter)
+{
+	auto* scriptLambda = iter->first;
+	auto& ctx = iter->second;
+	SetLambdaParent(scriptLambda, ctx, nullptr);
+	EraseFromIndex(g_lambdasByParentScript, ctx.parentScript, scriptLambda);
+	if (const auto posIter = g_lambdaScriptPosMap.find(ctx.posKey); posIter != g_lambdaScriptPosMap.end() && posIter->second == scriptLambda)
+		g_lambdaScriptPosMap.erase(posIter);
+	g_lambdas.erase(iter);
 }
 
 LambdaManager::Maybe_Lambda::Maybe_Lambda(Maybe_Lambda&& other) noexcept
@@ -162,8 +198,10 @@ Script* LambdaManager::CreateLambdaScript(UInt8* position, const ScriptData& scr
 	}
 	auto iter = g_lambdas.emplace(scriptLambda, LambdaContext());
 	auto& ctx = iter.first->second;
-	SetLambdaParent(ctx, parentEventList);
+	SetLambdaParent(scriptLambda, ctx, parentEventList);
+	ctx.posKey = key;
 	ctx.parentScript = parentScript;
+	g_lambdasByParentScript[parentScript].insert(scriptLambda);
 #if _DEBUG
 	ctx.name = std::string(parentScript->GetName()) + "LambdaAt" + std::to_string(*exprEval.m_opcodeOffsetPtr);
 	scriptLambda->SetEditorID(ctx.name.c_str());
@@ -174,22 +212,18 @@ Script* LambdaManager::CreateLambdaScript(UInt8* position, const ScriptData& scr
 
 FormID GetFormIDForLambda(ScriptLambda* scriptLambda)
 {
-	const auto spIt = std::ranges::find_if(g_lambdaScriptPosMap, [&](auto& p)
-	{
-		auto& [pair, lambda] = p;
-		return lambda == scriptLambda;
-	});
-	if (spIt == g_lambdaScriptPosMap.end())
+	const auto* ctx = GetLambdaContext(scriptLambda);
+	if (!ctx)
 		return 0;
-	return spIt->first.second;
+	return ctx->posKey.second;
 }
 
 auto GetLambdaForParentIter(ScriptEventList* parentEventList)
 {
-	return std::ranges::find_if(g_lambdas, [&](auto& p)
-	{
-		return p.second.parentEventList == parentEventList;
-	});
+	const auto iter = g_lambdasByParentEventList.find(parentEventList);
+	if (iter == g_lambdasByParentEventList.end())
+		return g_lambdas.end();
+	return g_lambdas.find(*iter->second.begin());
 }
 
 Script* GetLambdaForParent(ScriptEventList* parentEventList)
@@ -218,37 +252,30 @@ bool LambdaManager::IsScriptLambda(Script* scriptLambda)
 void LambdaManager::DeleteAllForParentScript(Script* parentScript)
 {
 	ScopedLock lock(g_lambdaCs);
-	std::vector<Script*> lambdas;
-	int numLambdas = 0;
-	for (auto& [scriptLambda, ctx] : g_lambdas)
+	std::unordered_set<Script*> lambdas;
+	if (const auto iter = g_lambdasByParentScript.find(parentScript); iter != g_lambdasByParentScript.end())
 	{
-		if (ctx.parentScript == parentScript)
-		{
-			FormHeap_Free(scriptLambda->data); // ThisStdCall(0x5AA1A0, scriptLambda); // call destructor to free parentScript data pointer
-			lambdas.push_back(scriptLambda);
-			ctx.parentEventList = nullptr;
-			scriptLambda->data = nullptr; // parentScript data and tLists will be freed but parentScript won't be since plugins may store pointers to it to call
-			scriptLambda->varList = {};
-			scriptLambda->refList = {};
-			++numLambdas;
-		}
+		lambdas = std::move(iter->second);
+		g_lambdasByParentScript.erase(iter);
 	}
-	for (auto& ctx : g_lambdas | std::views::values)
+	const int numLambdas = lambdas.size();
+	for (auto* scriptLambda : lambdas)
 	{
-		if (!ctx.capturedLambdaVariableScripts)
-			continue;
-		auto iter = std::ranges::find_if(*ctx.capturedLambdaVariableScripts, [&](Script* script)
-		{
-			return std::ranges::find(lambdas, script) != lambdas.end();
-		});
-		if (iter != ctx.capturedLambdaVariableScripts->end())
-			ctx.capturedLambdaVariableScripts = std::nullopt;
+		FormHeap_Free(scriptLambda->data); // ThisStdCall(0x5AA1A0, scriptLambda); // call destructor to free parentScript data pointer
+		scriptLambda->data = nullptr; // parentScript data and tLists will be freed but parentScript won't be since plugins may store pointers to it to call
+		scriptLambda->varList = {};
+		scriptLambda->refList = {};
 	}
-	std::erase_if(g_lambdaScriptPosMap, [&](auto& p) { return std::ranges::find(lambdas, p.second) != lambdas.end(); });
-	std::erase_if(g_lambdas, [&](auto& p)
+	if (numLambdas)
 	{
-		return std::ranges::find(lambdas, p.first) != lambdas.end();
-	});
+		for (auto& ctx : g_lambdas | std::views::values)
+		{
+			if (ctx.capturedLambdaVariableScripts && std::ranges::any_of(*ctx.capturedLambdaVariableScripts, _L(Script* script, lambdas.contains(script))))
+				ctx.capturedLambdaVariableScripts = std::nullopt;
+		}
+	}
+	for (auto* scriptLambda : lambdas)
+		EraseLambda(g_lambdas.find(scriptLambda));
 	g_savedVarLists.clear();
 
 	if (numLambdas)
@@ -293,11 +320,12 @@ ScriptEventList* LambdaManager::GetParentEventList(Script* scriptLambda)
 
 void RemoveEventList(ScriptEventList* eventList)
 {
-	for (auto& ctx : g_lambdas | std::views::values)
-	{
-		if (ctx.parentEventList == eventList)
-			ctx.parentEventList = nullptr;
-	}
+	const auto iter = g_lambdasByParentEventList.find(eventList);
+	if (iter == g_lambdasByParentEventList.end())
+		return;
+	for (auto* scriptLambda : iter->second)
+		g_lambdas[scriptLambda].parentEventList = nullptr;
+	g_lambdasByParentEventList.erase(iter);
 }
 
 void LambdaManager::MarkParentAsDeleted(ScriptEventList* parentEventList)
@@ -320,6 +348,7 @@ void LambdaManager::MarkParentAsDeleted(ScriptEventList* parentEventList)
 
 void LambdaManager::MarkScriptAsDeleted(Script* script)
 {
+	ScopedLock lock(g_lambdaCs);
 	for (auto& iter : g_savedVarLists)
 	{
 		auto* copiedScriptEventList = iter.first;
@@ -346,8 +375,8 @@ void LambdaManager::MarkScriptAsDeleted(Script* script)
 		// rest is probably unnecessary but done just in case
 		ctx.lambdas.erase(script);
 	}
-	g_lambdas.erase(script);
-	std::erase_if(g_lambdaScriptPosMap, _L(auto& p, p.second == script));
+	if (const auto iter = g_lambdas.find(script); iter != g_lambdas.end())
+		EraseLambda(iter);
 
 }
 
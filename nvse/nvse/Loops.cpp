@@ -17,7 +17,7 @@ LoopManager* LoopManager::GetSingleton()
 	return localData.loopManager;
 }
 
-ArrayIterLoop::ArrayIterLoop(const ForEachContext* context, UInt8 modIndex) : m_modIndex(modIndex)
+ArrayIterLoop::ArrayIterLoop(const ForEachContext* context, UInt8 modIndex) : m_curIndex(0), m_modIndex(modIndex)
 {
 	m_srcID = context->sourceID;
 	m_iterID = context->iteratorID;
@@ -40,13 +40,25 @@ ArrayIterLoop::ArrayIterLoop(const ForEachContext* context, UInt8 modIndex) : m_
 	}
 }
 
+// "key" sorts before "value", so unless a script has altered the iterator they are its first two elements
+static ArrayElement* GetIteratorSlot(ArrayVar* iterArr, UInt32 index, const char* key)
+{
+	if (index < iterArr->Size() && iterArr->GetContainerType() == kContainer_StringMap)
+	{
+		ArrayIterator iter = iterArr->GetRawContainer()->seek(index);
+		if (!StrCompare(iter.first()->key.str, key))
+			return iter.second();
+	}
+	return iterArr->Get(key, true);
+}
+
 void ArrayIterLoop::UpdateIterator(const ArrayElement* elem)
 {
 	ArrayVar *arr = g_ArrayMap.Get(m_iterID);
 	if (!arr) return;
 
 	// iter["key"] = element key
-	ArrayElement *newElem = arr->Get("key", true);
+	ArrayElement *newElem = GetIteratorSlot(arr, 0, "key");
 	if (newElem)
 	{
 		if (m_curKey.KeyType() == kDataType_String)
@@ -54,7 +66,7 @@ void ArrayIterLoop::UpdateIterator(const ArrayElement* elem)
 		else newElem->SetNumber(m_curKey.key.num);
 	}
 	// iter["value"] = element data
-	newElem = arr->Get("value", true);
+	newElem = GetIteratorSlot(arr, 1, "value");
 	if (newElem) newElem->Set(elem);
 }
 
@@ -65,7 +77,7 @@ bool ArrayIterLoop::Update(COMMAND_ARGS)
 	{
 		ArrayElement *elem;
 		const ArrayKey *key;
-		if (arr->GetNextElement(&m_curKey, &elem, &key))
+		if (arr->GetNextElement(&m_curKey, m_curIndex, &elem, &key))
 		{
 			m_curKey = *key;
 			UpdateIterator(elem);	
@@ -91,10 +103,16 @@ StringIterLoop::StringIterLoop(const ForEachContext* context)
 		m_curIndex = 0;
 		m_iterID = context->iteratorID;
 		if (m_src.length())
-			iterVar->Set(m_src.substr(0, 1).c_str());
+			UpdateIterator(iterVar);
 	}
 }
 
+void StringIterLoop::UpdateIterator(StringVar* iterVar) const
+{
+	const char chr[2] = {m_src[m_curIndex], 0};
+	iterVar->Set(chr);
+}
+
 bool StringIterLoop::Update(COMMAND_ARGS)
 {
 	StringVar* iterVar = g_StringMap.Get(m_iterID);
@@ -103,7 +121,7 @@ bool StringIterLoop::Update(COMMAND_ARGS)
 		m_curIndex++;
 		if (m_curIndex < m_src.length())
 		{
-			iterVar->Set(m_src.substr(m_curIndex, 1).c_str());
+			UpdateIterator(iterVar);
 			return true;
 		}
 	}
@@ -116,7 +134,9 @@ ContainerIterLoop::ContainerIterLoop(const ForEachContext* context)
 	TESObjectREFR* contRef = (TESObjectREFR*)context->sourceID;
 	m_refVar = context->var;
 	m_iterIndex = 0;
+	m_curEntry = NULL;
 	m_invRef = CreateInventoryRef(contRef, IRefData(), false);
+	m_numDeferredActions = 0;
 
 	InventoryItemsMap invItems(0x40);
 	if (contRef->GetInventoryItems(invItems))
@@ -141,12 +161,12 @@ ContainerIterLoop::ContainerIterLoop(const ForEachContext* context)
 					if (xCount > baseCount)
 						xCount = baseCount;
 					baseCount -= xCount;
-					m_elements.Append(CreateTempEntry(item, xCount, xData));
+					m_elements.Append(ItemStack{item, xCount, xData});
 					if (!baseCount) break;
 				}
 			}
 			if (baseCount > 0)
-				m_elements.Append(CreateTempEntry(item, baseCount, NULL));
+				m_elements.Append(ItemStack{item, baseCount, NULL});
 		}
 	}
 
@@ -154,9 +174,46 @@ ContainerIterLoop::ContainerIterLoop(const ForEachContext* context)
 	SetIterator();
 }
 
+ContainerIterLoop::EntryData* ContainerIterLoop::AcquireEntry(const ItemStack& stack)
+{
+	if (m_freeEntries.Empty())
+		return CreateTempEntry(stack.item, stack.count, stack.xData);
+
+	EntryData *entry = m_freeEntries.Top();
+	m_freeEntries.Pop();
+	if (stack.xData)
+	{
+		if (!entry->extendData)
+			entry->extendData = (ExtraContainerChanges::ExtendDataList*)FormHeap_Allocate(8);
+		entry->extendData->Init(stack.xData);
+	}
+	else if (entry->extendData)
+	{
+		FormHeap_Free(entry->extendData);
+		entry->extendData = NULL;
+	}
+	entry->countDelta = stack.count;
+	entry->type = stack.item;
+	return entry;
+}
+
 bool ContainerIterLoop::UnsetIterator()
 {
-	return m_invRef->WriteRefDataToContainer();
+	const bool result = m_invRef->WriteRefDataToContainer();
+	if (m_curEntry)
+	{
+		// deferred actions keep pointers to the entry of the item they were queued for
+		const UInt32 numDeferredActions = m_invRef->m_deferredActions.Size();
+		if (numDeferredActions != m_numDeferredActions)
+		{
+			m_heldEntries.Append(m_curEntry);
+			m_numDeferredActions = numDeferredActions;
+		}
+		else
+			m_freeEntries.Append(m_curEntry);
+		m_curEntry = NULL;
+	}
+	return result;
 }
 
 bool ContainerIterLoop::SetIterator()
@@ -164,9 +221,8 @@ bool ContainerIterLoop::SetIterator()
 	TESObjectREFR* refr = m_invRef->GetRef();
 	if (m_iterIndex < m_elements.Size() && refr)
 	{
-		ExtraContainerChanges::EntryData *entry = m_elements[m_iterIndex];
-		ExtraDataList *xData = entry->extendData ? entry->extendData->GetFirstItem() : NULL;
-		m_invRef->SetData(IRefData(entry->type, entry, xData));
+		m_curEntry = AcquireEntry(m_elements[m_iterIndex]);
+		m_invRef->SetData(IRefData(m_curEntry->type, m_curEntry, m_elements[m_iterIndex].xData));
 		*((UInt64*)&m_refVar->data) = refr->refID;
 		return true;
 	}
@@ -188,13 +244,19 @@ bool ContainerIterLoop::Update(COMMAND_ARGS)
 
 ContainerIterLoop::~ContainerIterLoop()
 {
-	for (auto iter = m_elements.Begin(); !iter.End(); ++iter)
+	if (m_curEntry)
+		m_heldEntries.Append(m_curEntry);
+	// runs the deferred actions, which still read their entries
+	m_invRef->Release();
+	for (auto* entries : {&m_freeEntries, &m_heldEntries})
 	{
-		if (iter->extendData)
-			FormHeap_Free(iter->extendData);
-		FormHeap_Free(*iter);
+		for (auto iter = entries->Begin(); !iter.End(); ++iter)
+		{
+			if (iter->extendData)
+				FormHeap_Free(iter->extendData);
+			FormHeap_Free(*iter);
+		}
 	}
-	m_invRef->Release();
 	m_refVar->data = 0;
 }
 
@@ -13,6 +13,7 @@
 #include "FastStack.h"
 
 class ScriptRunner;
+class StringVar;
 struct ForEachContext;
 
 // abstract base for Loop classes
@@ -53,6 +54,7 @@ class ArrayIterLoop : public ForEachLoop
 	ArrayID m_srcID;
 	ArrayID m_iterID;
 	ArrayKey m_curKey;
+	UInt32 m_curIndex;	// position of m_curKey in the source array, checked against the key before each step
 	UInt8 m_modIndex;
 
 	void UpdateIterator(const ArrayElement *elem);
@@ -78,6 +80,8 @@ class StringIterLoop : public ForEachLoop
 	UInt32 m_curIndex;
 	UInt32 m_iterID;
 
+	void UpdateIterator(StringVar *iterVar) const;
+
 public:
 	StringIterLoop(const ForEachContext *context);
 	virtual ~StringIterLoop() {}
@@ -90,12 +94,26 @@ public:
 class ContainerIterLoop : public ForEachLoop
 {
 	typedef InventoryReference::Data IRefData;
+	typedef ExtraContainerChanges::EntryData EntryData;
+
+	// a stack of items in the container when the loop started, its temp entry is only built once the loop reaches it
+	struct ItemStack
+	{
+		TESForm			*item;
+		SInt32			count;
+		ExtraDataList	*xData;
+	};
 
 	InventoryReference *m_invRef;
 	ScriptLocal *m_refVar;
 	UInt32 m_iterIndex;
-	Vector<ExtraContainerChanges::EntryData *> m_elements;
+	Vector<ItemStack> m_elements;
+	EntryData *m_curEntry;
+	UInt32 m_numDeferredActions;		// deferred actions of m_invRef queued before the current item
+	Vector<EntryData *> m_freeEntries;	// temp entries no longer referenced, reused for later items
+	Vector<EntryData *> m_heldEntries;	// temp entries referenced by deferred actions, freed after those have run
 
+	EntryData *AcquireEntry(const ItemStack &stack);
 	bool SetIterator();
 	bool UnsetIterator();
 
@@ -529,7 +529,7 @@ struct NVSECommandTableInterface
 struct NVSEScriptInterface
 {
 	enum {
-		kVersion = 1
+		kVersion = 2
 	};
 
 	bool	(* CallFunction)(Script* funcScript, TESObjectREFR* callingObj, TESObjectREFR* container,
@@ -560,6 +560,18 @@ struct NVSEScriptInterface
 	//
 	// *if expression contains SetFunctionValue and %R for line breaks it can be multiline as well
 	Script* (*CompileExpression)(const char* expression);
+
+	// version 2
+	// Calls funcScript once for each of numCalls argument tuples, reusing the same function context and variable
+	// list across calls. args holds numCalls * numArgs values laid out call after call, each passed the same way as
+	// CallFunction's variadic args. If results is not null, results[i] is set to the return value of call i.
+	// Returns the number of calls that succeeded (that returned a value, if results is not null).
+	// Example:
+	//   void* args[3][2] = {{actor1, (void*)1}, {actor2, (void*)2}, {actor3, (void*)3}};
+	//   NVSEArrayVarInterface::Element results[3];
+	//   g_scriptInterface->CallFunctionBatch(script, nullptr, nullptr, 2, &args[0][0], 3, results);
+	UInt32	(*CallFunctionBatch)(Script* funcScript, TESObjectREFR* callingObj, TESObjectREFR* container,
+		UInt8 numArgs, void* const* args, UInt32 numCalls, NVSEArrayVarInterface::Element* results);
 };
 
 #endif
@@ -63,7 +63,8 @@ static NVSEScriptInterface g_NVSEScriptInterface =
 	ExtractFormatStringArgs,
 	PluginAPI::CallFunctionScriptAlt,
 	CompileScript,
-	CompileExpression
+	CompileExpression,
+	PluginAPI::CallFunctionScriptBatch
 };
 
 #endif
@@ -946,6 +947,7 @@ extern UnorderedSet<UInt32> s_gameLoadedInformedScripts, s_gameRestartedInformed
 void PluginManager::ClearScriptDataCache()
 {
 	TokenCache::MarkForClear();
+	ScriptEventList::InvalidateVariableIndexes();
 	UserFunctionManager::ClearInfos();
 	Dispatch_Message(0, NVSEMessagingInterface::kMessage_ClearScriptDataCache, NULL, 0, NULL);
 	// LambdaManager::ClearCache(); Instead use LambdaClearForParentScript
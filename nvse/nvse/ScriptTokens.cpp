@@ -192,7 +192,9 @@ std::string ScriptToken::GetVariableDataAsString() const
 	{
 	case kTokenType_NumericVar:
 	{
-		return FormatString("%g", GetNumber());
+		char numBuf[0x20];
+		NumToStr(numBuf, GetNumber());
+		return numBuf;
 	}
 	case kTokenType_RefVar:
 	{
@@ -963,7 +965,7 @@ ScriptLocal* GetScriptLocal(UInt32 varIdx, UInt32 refIdx, Script* script, Script
 		}
 	}
 	if (eventList)
-		return eventList->GetVariable(varIdx);
+		return eventList->GetVariableIndexed(varIdx);
 	return nullptr;
 }
 
@@ -1066,7 +1068,11 @@ std::string ScriptToken::GetStringRepresentation() const
 	if (CanConvertTo(kTokenType_String))
 		return GetString();
 	if (CanConvertTo(kTokenType_Number))
-		return FormatString("%g", GetNumber());
+	{
+		char numBuf[0x20];
+		NumToStr(numBuf, GetNumber());
+		return numBuf;
+	}
 	if (CanConvertTo(kTokenType_Form) && GetTESForm())
 		return GetTESForm()->GetStringRepresentation();
 	if (CanConvertTo(kTokenType_Array) && GetArrayVar())
@@ -1572,14 +1578,14 @@ double ScriptToken::GetNumericRepresentation(bool bFromHex) const
 		if (!bFromHex)
 		{
 			// if string begins with "0x", interpret as hex
-			Tokenizer tok(str, " \t\r\n");
-			std::string pre;
-			if (tok.NextToken(pre) != -1 && pre.length() >= 2 && !StrCompare(pre.substr(0, 2).c_str(), "0x"))
-				bFromHex = true;
+			const char *pre = str;
+			while ((*pre == ' ') || (*pre == '\t') || (*pre == '\r') || (*pre == '\n'))
+				pre++;
+			bFromHex = (pre[0] == '0') && ((pre[1] | 0x20) == 'x');
 		}
 
 		if (!bFromHex)
-			result = strtod(str, NULL);
+			result = StrToDbl(str);
 		else
 		{
 			UInt32 hexInt = 0;
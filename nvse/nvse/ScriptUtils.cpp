@@ -316,6 +316,24 @@ char *__fastcall ConcatStrings(const char *lStr, const char *rStr)
 std::unique_ptr<ScriptToken> Eval_Add_String(OperatorType op, ScriptToken *lh, ScriptToken *rh, ExpressionEvaluator *context)
 {
 	auto token = ScriptToken::Create(static_cast<const char*>(nullptr));
+	// a temporary left operand (the result of a previous + in a chain like a + b + c) is deleted after this,
+	// so take its buffer and grow it geometrically rather than copying everything built so far again
+	if (lh->type == kTokenType_String && !lh->cached && lh->value.str)
+	{
+		const char *rStr = rh->GetString();
+		const UInt32 lLen = StrLen(lh->value.str), rLen = StrLen(rStr), size = lLen + rLen + 1;
+		char *buffer = lh->value.str;
+		if (_msize(buffer) < size)
+		{
+			buffer = static_cast<char*>(realloc(buffer, (size > lLen * 2) ? size : lLen * 2));
+			if (!buffer)
+				return nullptr;
+		}
+		memcpy(buffer + lLen, rStr, rLen + 1);
+		lh->value.str = nullptr;
+		token->value.str = buffer;
+		return token;
+	}
 	token->value.str = ConcatStrings(lh->GetString(), rh->GetString());
 	return token;
 }
@@ -434,6 +452,10 @@ std::unique_ptr<ScriptToken> Eval_Assign_String(OperatorType op, ScriptToken *lh
 		return ScriptToken::Create(lhVar, lhStrVar);
 	}
 	
+	// s := s, including s := s + x after AppendToStringVarInPlace
+	if (lhStrVar && rh->GetStringVar() == lhStrVar)
+		return ScriptToken::Create(lhVar, lhStrVar);
+
 	const char *str = rh->GetString();
 	if (!lhStrVar)
 		lhVar->data = static_cast<int>(AddStringVar(str, *lh, *context, &lhStrVar));
@@ -746,12 +768,16 @@ std::unique_ptr<ScriptToken> Eval_TimesEquals_String(OperatorType op, ScriptToke
 		strVar = g_StringMap.Get(strID);
 	}
 
-	const std::string str = strVar->String();
+	// appends the string's own leading part in place rather than copying it first
+	std::string &str = strVar->StringRef();
+	const size_t length = str.length();
 
 	int rhNum = rh->GetNumber();
+	if (rhNum > 0)
+		str.reserve(length * (rhNum + 1));
 	while (rhNum > 0)
 	{
-		strVar->StringRef() += str;
+		str.append(str, 0, length);
 		rhNum--;
 	}
 
@@ -1130,7 +1156,7 @@ std::unique_ptr<ScriptToken> Eval_ToString_String(OperatorType op, ScriptToken *
 std::unique_ptr<ScriptToken> Eval_ToString_Number(OperatorType op, ScriptToken *lh, ScriptToken *rh, ExpressionEvaluator *context)
 {
 	char buf[0x20];
-	snprintf(buf, sizeof buf, "%g", lh->GetNumber());
+	NumToStr(buf, lh->GetNumber());
 	return ScriptToken::Create(static_cast<const char*>(buf));
 }
 
@@ -1737,6 +1763,12 @@ void ExpressionEvaluator::Error(const char *fmt, ...)
 	if (m_flags.IsSet(kFlag_SuppressErrorMessages))
 		return;
 
+	// the first error decides whether this evaluation's errors get shown
+	if (errorMessages.empty() && !m_flags.IsSet(kFlag_ErrorThrottled) && !RuntimeErrorThrottle::Admit(script, m_baseOffset, fmt))
+		m_flags.Set(kFlag_ErrorThrottled);
+	if (m_flags.IsSet(kFlag_ErrorThrottled))
+		return;
+
 	va_list args;
 	va_start(args, fmt);
 
@@ -2115,6 +2147,108 @@ bool GetUserFunctionParamNames(const std::string &scriptText, std::vector<std::s
 	return false;
 }
 
+// annotations following the parameter list of the function definition, e.g. "Begin Function {iValue} pure"
+// unknown words are ignored so that existing scripts with trailing text keep compiling
+static UInt8 GetUserFunctionFlags(const std::string &scriptText)
+{
+	std::string lineText;
+	Tokenizer lines(scriptText.c_str(), "\r\n");
+	while (lines.NextToken(lineText) != -1)
+	{
+		Tokenizer tokens(lineText.c_str(), " \t\r\n\0;");
+
+		std::string token;
+		if (tokens.NextToken(token) != -1 && !StrCompare(token.c_str(), "begin"))
+		{
+			const UInt32 argEndPos = lineText.find('}');
+			if (argEndPos == -1)
+				return 0;
+			std::string flagStr = lineText.substr(argEndPos + 1);
+			flagStr = flagStr.substr(0, flagStr.find(';'));
+
+			UInt8 flags = 0;
+			Tokenizer flagTokens(flagStr.c_str(), "\t ,");
+			while (flagTokens.NextToken(token) != -1)
+			{
+				if (!StrCompare(token.c_str(), "pure"))
+					flags |= kUserFunctionFlag_Pure;
+			}
+			return flags;
+		}
+	}
+	return 0;
+}
+
+// lambdas compile into their parent's var list, so a variable is captured when the lambda reads a name it doesn't declare
+// itself, as a parameter or a local; checked on the text, as classic lines are compiled by the game
+static bool LambdaReadsParentVariable(const std::string &lambdaText, ScriptBuffer *parentBuf)
+{
+	struct Identifier
+	{
+		std::string name;
+		bool member;		// follows a '.', a variable of another script
+		bool declared;
+	};
+	std::vector<Identifier> identifiers;
+	std::string lineText;
+	Tokenizer lines(lambdaText.c_str(), "\r\n");
+	while (lines.NextToken(lineText) != -1)
+	{
+		const UInt32 firstIdentifier = identifiers.size();
+		bool isDeclaration = false, pastAssignment = false, inString = false;
+		for (UInt32 pos = 0; pos < lineText.size(); )
+		{
+			const char ch = lineText[pos];
+			if (inString)
+			{
+				inString = ch != '"';
+				pos++;
+			}
+			else if (ch == ';')
+				break;
+			else if (ch == '"')
+			{
+				inString = true;
+				pos++;
+			}
+			else if (isalpha(static_cast<unsigned char>(ch)) || ch == '_')
+			{
+				const UInt32 start = pos;
+				while (pos < lineText.size() && (isalnum(static_cast<unsigned char>(lineText[pos])) || lineText[pos] == '_'))
+					pos++;
+				std::string name = lineText.substr(start, pos - start);
+				if (identifiers.size() == firstIdentifier)
+				{
+					// a begin line declares its parameters, a type name its locals
+					isDeclaration = !StrCompare(name.c_str(), "begin") || !StrCompare(name.c_str(), "short") || !StrCompare(name.c_str(), "long")
+						|| ra::any_of(g_variableTypeNames, _L(const char* typeName, !StrCompare(typeName, name.c_str())));
+				}
+				identifiers.push_back({std::move(name), start && lineText[start - 1] == '.', isDeclaration && !pastAssignment});
+			}
+			else
+			{
+				if (ch == '=')
+					pastAssignment = true;
+				else if (isdigit(static_cast<unsigned char>(ch)))
+				{
+					while (pos < lineText.size() && isalnum(static_cast<unsigned char>(lineText[pos])))
+						pos++;
+					continue;
+				}
+				pos++;
+			}
+		}
+	}
+	for (const auto &identifier : identifiers)
+	{
+		if (identifier.declared || identifier.member || !parentBuf->GetVariableByName(identifier.name.c_str()))
+			continue;
+		if (ra::none_of(identifiers, _L(const Identifier &other, other.declared && !StrCompare(other.name.c_str(), identifier.name.c_str()))))
+			return true;
+	}
+	return false;
+}
+
 bool ExpressionParser::GetUserFunctionParams(const std::vector<std::string> &paramNames, std::vector<UserFunctionParam> &outParams, Script::VarInfoList *varList, const std::string &fullScriptText, Script *script) const
 {
 	auto lastVarType = Script::eVarType_Invalid;
@@ -2293,6 +2427,7 @@ bool ExpressionParser::ParseUserFunctionDefinition() const
 	//	UserFunctionParam	params[numParams]			{ UInt16 varIdx; UInt8 varType }
 	//	UInt8				numLocalArrayVars
 	//	UInt16				localArrayVarIndexes[numLocalArrayVars]
+	//	UInt8				flags						optional, only written if non-zero (see UserFunctionFlags)
 
 	// write version
 	m_lineBuf->WriteByte(kUserFunction_Version);
@@ -2377,6 +2512,10 @@ bool ExpressionParser::ParseUserFunctionDefinition() const
 		m_lineBuf->Write16(arrayVarIndexes[i]);
 	}
 
+	// older versions stop reading before this, so leaving it out keeps unannotated functions byte-identical
+	if (const UInt8 flags = GetUserFunctionFlags(m_scriptBuf->scriptText))
+		m_lineBuf->WriteByte(flags);
+
 	return true;
 }
 
@@ -2799,6 +2938,13 @@ std::unique_ptr<ScriptToken> ExpressionParser::ParseLambda()
 	auto *lambdaText = static_cast<char *>(FormHeap_Allocate(textLen));
 	memset(lambdaText, 0, textLen);
 	std::memcpy(lambdaText, beginData, textLen);
+	// memoized results are keyed on the arguments only, a captured variable would make them stale
+	if ((GetUserFunctionFlags(lambdaText) & kUserFunctionFlag_Pure) && LambdaReadsParentVariable(lambdaText, m_scriptBuf))
+	{
+		PrintCompileError("A pure lambda can't read variables of the enclosing script, pass them as arguments instead");
+		FormHeap_Free(lambdaText);
+		return nullptr;
+	}
 	const auto lambdaScriptBuf = ScriptBuffer::MakeUnique();
 	auto scriptLambda = Script::MakeUnique();
 
@@ -3295,7 +3441,7 @@ std::unique_ptr<ScriptToken> ExpressionParser::ParseOperand(Operator *curOp)
 	}
 	// try to convert to a number
 	char *leftOvers = nullptr;
-	const double dVal = strtod(token.c_str(), &leftOvers);
+	const double dVal = StrToDbl(token.c_str(), &leftOvers);
 	if (*leftOvers == 0) // entire string parsed as a double
 		return ScriptToken::Create(dVal);
 
@@ -3598,7 +3744,8 @@ void ExpressionEvaluator::PushOnStack()
 	{
 		// inherit flags
 		m_flags.RawSet(top->m_flags.Get());
-		m_flags.Clear(kFlag_ErrorOccurred);
+		// errors are admitted and throttled per evaluator, a nested one reports at its own site
+		m_flags.Clear(kFlag_ErrorOccurred | kFlag_ErrorThrottled);
 	}
 }
 
@@ -3658,7 +3805,7 @@ ExpressionEvaluator::~ExpressionEvaluator()
 		// include mod filename, save having to ask users to figure it out themselves
 		const char *modName = GetModName(script);
 
-		ShowRuntimeError(script, "%s\n    File: %s Offset: 0x%04X Command: %s", error.c_str(), modName, m_baseOffset, cmd ? cmd->longName : "<unknown>");
+		ShowAdmittedRuntimeError(script, "%s\n    File: %s Offset: 0x%04X Command: %s", error.c_str(), modName, m_baseOffset, cmd ? cmd->longName : "<unknown>");
 		if (m_flags.IsSet(kFlag_StackTraceOnError))
 			PrintStackTrace();
 	}
@@ -3865,15 +4012,19 @@ bool ExpressionEvaluator::ExtractFormatStringArgs(va_list varArgs, UInt32 fmtStr
 		}
 
 		// grab the format string
-		const char *fmt = Arg(fmtStringPos)->GetString();
+		const ScriptToken *fmtToken = Arg(fmtStringPos);
+		const char *fmt = fmtToken->GetString();
 		if (!fmt)
 		{
 			return false;
 		}
 
+		// only a string literal keeps its text and address across calls, string vars and expression results are parsed each time
+		const void *planKey = fmtToken->cached && fmtToken->Type() == kTokenType_String ? fmt : nullptr;
+
 		// interpret the format string
 		OverriddenScriptFormatStringArgs fmtArgs(this, fmtStringPos);
-		if (ExtractFormattedString(fmtArgs, fmtStringOut))
+		if (ExtractFormattedString(fmtArgs, fmtStringOut, planKey))
 		{
 			// convert and store any remaining cmd args
 			const UInt32 trailingArgsOffset = fmtArgs.GetCurArgIndex();
@@ -4661,6 +4812,27 @@ bool ExpressionEvaluator::ParseBytecode(CachedTokens &cachedTokens)
 
 using OperandStack = FastStack<ScriptToken *>;
 
+// let s := s + x
+// Appends x to s in place when the + result goes straight into an assignment back to s, instead of building s + x and
+// copying it over s, which makes building a string up in a loop quadratic. The assignment then sees s assigned to itself.
+static std::unique_ptr<ScriptToken> AppendToStringVarInPlace(const TokenCacheEntry *nextEntry, OperandStack &operands, ScriptToken *lh, ScriptToken *rh)
+{
+	if (!nextEntry || !operands.Size() || (nextEntry->token->Type() != kTokenType_Operator) || (nextEntry->token->GetOperator()->type != kOpType_Assignment))
+		return nullptr;
+	ScriptToken *target = operands.Top();
+	if ((target->Type() != kTokenType_StringVar) || (lh->Type() != kTokenType_StringVar) || !lh->GetVar() || (target->GetVar() != lh->GetVar()) || !rh->CanConvertTo(kTokenType_String))
+		return nullptr;
+	StringVar *strVar = lh->GetStringVar();
+	if (!strVar || (target->GetStringVar() != strVar))
+		return nullptr;
+	std::string &str = strVar->StringRef();
+	const char *rStr = rh->GetString();
+	if ((rStr >= str.data()) && (rStr <= str.data() + str.size()))
+		return nullptr;
+	str += rStr;
+	return ScriptToken::Create(lh->GetVar(), strVar);
+}
+
 bool ShortCircuit(OperandStack &operands, CachedTokenIter &iter)
 {
 	ScriptToken *lastToken = operands.Top();
@@ -4795,14 +4967,16 @@ ScriptToken *ExpressionEvaluator::Evaluate()
 				operands.Pop();
 			}
 	
-			ScriptToken *opResult;
-			if (entry.eval == nullptr)
-			{
-				opResult = op->Evaluate(lhOperand, rhOperand, this, entry.eval, entry.swapOrder).release();
-			}
-			else
+			ScriptToken *opResult = nullptr;
+			if ((op->type == kOpType_Add) && rhOperand && ((&entry + 1) < cache.DataEnd()))
+				opResult = AppendToStringVarInPlace(&entry + 1, operands, lhOperand, rhOperand).release();
+
+			if (!opResult)
 			{
-				opResult = entry.swapOrder ? entry.eval(op->type, rhOperand, lhOperand, this).release() : entry.eval(op->type, lhOperand, rhOperand, this).release();
+				if (entry.eval == nullptr)
+					opResult = op->Evaluate(lhOperand, rhOperand, this, entry.eval, entry.swapOrder).release();
+				else
+					opResult = entry.swapOrder ? entry.eval(op->type, rhOperand, lhOperand, this).release() : entry.eval(op->type, lhOperand, rhOperand, this).release();
 			}
 
 			delete lhOperand;
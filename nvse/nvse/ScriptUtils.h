@@ -136,6 +136,7 @@ class ExpressionEvaluator
 		kFlag_SuppressErrorMessages	= 1 << 0,
 		kFlag_ErrorOccurred			= 1 << 1,
 		kFlag_StackTraceOnError		= 1 << 2,
+		kFlag_ErrorThrottled		= 1 << 3,	// errors at this site are being suppressed, skip formatting them
 	};
 	MoveContainer moved_;
 	bool m_pushedOnStack;
@@ -1,11 +1,13 @@
 #include "Serialization.h"
 
 #include <stdexcept>
+#include <thread>
 
 #include "Core_Serialization.h"
 #include "common/IFileStream.h"
 #include "PluginManager.h"
 #include "GameAPI.h"
+#include "FunctionScripts.h"
 #include <vector>
 //#include "EventManager.h"
 
@@ -27,6 +29,12 @@ static UInt32 g_lastLoadSize = 0x40000;
 //		PluginHeader	plugin[header.numPlugins]
 //			ChunkHeader		chunk[plugin.numChunks]
 //				UInt8			data[chunk.length]
+//		PluginHeader	checksums			opcodeBase kChecksumOpcodeBase, not counted in header.numPlugins
+//			ChunkHeader		'CRCS'
+//				UInt32			numEntries
+//				ChecksumEntry	entry[numEntries]	one per preceding plugin block, in file order
+//
+//	the checksum block is treated as data for an unloaded plugin by older versions, which skip it
 	
 struct Header
 {
@@ -60,6 +68,16 @@ struct ChunkHeader
 	UInt32	length;
 };
 
+// CRC-32C over a plugin block, PluginHeader included
+struct ChecksumEntry
+{
+	UInt32	opcodeBase;
+	UInt32	crc;
+};
+
+static constexpr UInt32 kChecksumOpcodeBase = 0xFFFFFFFF;
+static constexpr UInt32 kChecksumChunkType = 'CRCS';
+
 SerializationTask s_serializationTask;
 
 typedef std::vector <PluginCallbacks>	PluginCallbackList;
@@ -189,9 +207,9 @@ void InternalSetPreLoadCallback(PluginHandle plugin, NVSESerializationInterface:
 void SerializationTask::PrepareSave()
 {
 	this->length = 0;
-	this->bufferSize = max(g_lastLoadSize, 0x40000);
-	this->bufferStart = std::make_unique<UInt8[]>(bufferSize);
-	this->bufferPtr = this->bufferStart.get();
+	this->saving = true;
+	this->segments.clear();
+	AddSegment(max(g_lastLoadSize, 0x40000));
 }
 
 bool SerializationTask::Save()
@@ -204,8 +222,14 @@ bool SerializationTask::Save()
 		_ERROR("HandleSaveGame: couldn't create save file (%s)", g_savePath.c_str());
 		return false;
 	}
+	this->length = max(this->length, GetOffset());
 	UInt32 numBytesWritten;
-	WriteFile(saveFile, bufferStart.get(), this->length, &numBytesWritten, NULL);
+	for (const auto &segment : segments)
+	{
+		if (segment.start >= this->length)
+			break;
+		WriteFile(saveFile, segment.data.get(), min(segment.size, this->length - segment.start), &numBytesWritten, NULL);
+	}
 	CloseHandle(saveFile);
 
 	Unload();
@@ -222,6 +246,7 @@ bool SerializationTask::Load()
 
 	const auto fileSize = GetFileSize(saveFile, nullptr);
 
+	this->saving = false;
 	this->bufferSize = fileSize;
 	this->bufferStart = std::make_unique<UInt8[]>(bufferSize);
 	this->bufferPtr = this->bufferStart.get();
@@ -234,110 +259,163 @@ bool SerializationTask::Load()
 	return bufferSize > 0;
 }
 
+void SerializationTask::LoadFromMemory(const void *data, UInt32 size)
+{
+	this->saving = false;
+	this->bufferSize = this->length = size;
+	this->bufferStart = std::make_unique_for_overwrite<UInt8[]>(size);
+	memcpy(this->bufferStart.get(), data, size);
+	this->bufferPtr = this->bufferStart.get();
+}
+
 void SerializationTask::Unload()
 {
 	this->bufferStart = nullptr;
 	this->bufferPtr = nullptr;
 	this->bufferSize = 0;
+	this->segments.clear();
+	this->segmentIdx = 0;
+	this->writePtr = this->writeEnd = nullptr;
+	this->saving = false;
 }
 
-UInt32 SerializationTask::GetOffset() const
+void SerializationTask::AddSegment(UInt32 minSize)
 {
-	return (UInt32)(bufferPtr - bufferStart.get());
+	UInt32 start = 0, size = minSize;
+	if (!segments.empty())
+	{
+		const auto &last = segments.back();
+		start = last.start + last.size;
+		if (size < last.size * 2)
+			size = last.size * 2;
+	}
+	auto &segment = segments.emplace_back(std::make_unique_for_overwrite<UInt8[]>(size), start, size);
+	segmentIdx = segments.size() - 1;
+	writePtr = segment.data.get();
+	writeEnd = writePtr + size;
 }
 
-void SerializationTask::SetOffset(UInt32 offset)
+// moves the write cursor to the start of the next segment, appending one if the cursor is in the last segment
+void SerializationTask::NextSegment(UInt32 minSize)
 {
-	if (offset > bufferSize)
-		Resize(offset);
-	bufferPtr = bufferStart.get() + offset;
+	if (segmentIdx + 1 < segments.size())
+	{
+		auto &segment = segments[++segmentIdx];
+		writePtr = segment.data.get();
+		writeEnd = writePtr + segment.size;
+	}
+	else AddSegment(minSize);
 }
 
-void SerializationTask::Skip(UInt32 size, bool read)
+void SerializationTask::WriteSlow(const void *inData, UInt32 size)
 {
-	if (read)
-		ValidateOffset(size);
-	else
-		CheckResize(size);
-	bufferPtr += size;
+	auto *src = static_cast<const UInt8*>(inData);
+	while (size)
+	{
+		if (writePtr == writeEnd)
+			NextSegment(size);
+		const UInt32 count = min(size, (UInt32)(writeEnd - writePtr));
+		memcpy(writePtr, src, count);
+		writePtr += count;
+		src += count;
+		size -= count;
+	}
 }
 
-void SerializationTask::Write8(UInt8 inData)
+void SerializationTask::SkipWrite(UInt32 size)
 {
-	CheckResize(sizeof(UInt8));
-	*bufferPtr++ = inData;
-	length += 1;
+	while (size)
+	{
+		if (writePtr == writeEnd)
+			NextSegment(size);
+		const UInt32 count = min(size, (UInt32)(writeEnd - writePtr));
+		writePtr += count;
+		size -= count;
+	}
 }
 
-void SerializationTask::Write16(UInt16 inData)
+UInt32 SerializationTask::GetOffset() const
 {
-	CheckResize(sizeof(UInt16));
-	*(UInt16*)bufferPtr = inData;
-	bufferPtr += 2;
-	length += 2;
+	if (saving)
+		return segments[segmentIdx].start + (UInt32)(writePtr - segments[segmentIdx].data.get());
+	return (UInt32)(bufferPtr - bufferStart.get());
 }
 
-void SerializationTask::Write32(UInt32 inData)
+void SerializationTask::SetOffset(UInt32 offset)
 {
-	CheckResize(sizeof(UInt32));
-	*(UInt32*)bufferPtr = inData;
-	bufferPtr += 4;
-	length += 4;
+	if (!saving)
+	{
+		// never seek past the data that was actually read
+		bufferPtr = bufferStart.get() + min(offset, this->length);
+		return;
+	}
+
+	// the furthest point written so far is only known while the cursor sits on it
+	this->length = max(this->length, GetOffset());
+	while (offset > segments.back().start + segments.back().size)
+		AddSegment(offset - segments.back().start - segments.back().size);
+
+	UInt32 idx = segments.size() - 1;
+	while (segments[idx].start > offset)
+		idx--;
+	segmentIdx = idx;
+	writePtr = segments[idx].data.get() + (offset - segments[idx].start);
+	writeEnd = segments[idx].data.get() + segments[idx].size;
 }
 
-void SerializationTask::Write64(const void *inData)
+void SerializationTask::Skip(UInt32 size)
 {
-	CheckResize(sizeof(double));
-	*(double*)bufferPtr = *(double*)inData;
-	bufferPtr += 8;
-	length += 8;
+	if (!saving)
+	{
+		ValidateOffset(size);
+		bufferPtr += size;
+	}
+	else if ((UInt32)(writeEnd - writePtr) >= size)
+		writePtr += size;
+	else
+		SkipWrite(size);
 }
 
 void SerializationTask::WriteBuf(const void *inData, UInt32 size)
 {
-	CheckResize(size);
+	if ((UInt32)(writeEnd - writePtr) < size)
+	{
+		WriteSlow(inData, size);
+		return;
+	}
 	switch (size)
 	{
 		case 0:
 			return;
 		case 1:
-			*bufferPtr = *(UInt8*)inData;
+			*writePtr = *(UInt8*)inData;
 			break;
 		case 2:
-			*(UInt16*)bufferPtr = *(UInt16*)inData;
+			*(UInt16*)writePtr = *(UInt16*)inData;
 			break;
-		case 3:
 		case 4:
-			*(UInt32*)bufferPtr = *(UInt32*)inData;
+			*(UInt32*)writePtr = *(UInt32*)inData;
 			break;
 		case 8:
-			*(double*)bufferPtr = *(double*)inData;
+			*(double*)writePtr = *(double*)inData;
 			break;
 		default:
-			memcpy(bufferPtr, inData, size);
+			memcpy(writePtr, inData, size);
 			break;
 	}
-	bufferPtr += size;
-	this->length += size;
-}
-
-void SerializationTask::Resize(UInt32 size)
-{
-	auto newLen = this->bufferSize * 2;
-	while (newLen < size)
-		newLen *= 2;
-	const auto offset = this->GetOffset();
-	auto newBuf = std::make_unique<UInt8[]>(newLen);
-	std::memcpy(newBuf.get(), this->bufferStart.get(), this->bufferSize);
-	this->bufferSize = newLen;
-	this->bufferStart = std::move(newBuf);
-	this->bufferPtr = this->bufferStart.get() + offset;
+	writePtr += size;
 }
 
-void SerializationTask::CheckResize(UInt32 size)
+void SerializationTask::Reserve(UInt32 size)
 {
-	if (GetOffset() + size > this->bufferSize)
-		Resize(size);
+	if ((UInt32)(writeEnd - writePtr) >= size)
+		return;
+	// only possible at the end of the data: cut the current segment short and continue in a fresh one
+	if ((segmentIdx + 1 != segments.size()) || (GetOffset() < this->length))
+		return;
+	auto &segment = segments[segmentIdx];
+	segment.size = (UInt32)(writePtr - segment.data.get());
+	AddSegment(size);
 }
 
 UInt8 SerializationTask::Read8()
@@ -421,6 +499,14 @@ void SerializationTask::PeekBuf(void *outData, UInt32 size)
 	}
 }
 
+const UInt8 *SerializationTask::ReadPtr(UInt32 size)
+{
+	ValidateOffset(size);
+	const UInt8 *result = bufferPtr;
+	bufferPtr += size;
+	return result;
+}
+
 void SerializationTask::ValidateOffset(UInt32 size) const
 {
 	if (GetOffset() + size > this->bufferSize)
@@ -429,6 +515,111 @@ void SerializationTask::ValidateOffset(UInt32 size) const
 	}
 }
 
+UInt32 SerializationTask::Checksum(UInt32 offset, UInt32 size) const
+{
+	if (!saving)
+		return CRC32C(bufferStart.get() + offset, size);
+
+	UInt32 crc = 0;
+	for (const auto &segment : segments)
+	{
+		if (!size)
+			break;
+		if (offset >= segment.start + segment.size)
+			continue;
+		const UInt32 segOffset = offset - segment.start;
+		const UInt32 count = min(size, segment.size - segOffset);
+		crc = CRC32C(segment.data.get() + segOffset, count, crc);
+		offset += count;
+		size -= count;
+	}
+	return crc;
+}
+
+//==========================================================================
+
+UInt8 *RecordBuffer::Grow(UInt32 count)
+{
+	if (size + count > alloc)
+		Reserve(size + count);
+	UInt8 *result = data + size;
+	size += count;
+	return result;
+}
+
+void RecordBuffer::Reserve(UInt32 count)
+{
+	if (count <= alloc)
+		return;
+	UInt32 newAlloc = alloc ? alloc : 0x1000;
+	while (newAlloc < count)
+		newAlloc <<= 1;
+	auto *newData = (UInt8*)realloc(data, newAlloc);
+	if (!newData)
+		throw std::bad_alloc();
+	data = newData;
+	alloc = newAlloc;
+}
+
+// below this many items the cost of spinning up workers outweighs the encoding itself
+static constexpr UInt32 kMinItemsPerWorkShard = 0x4000;
+static constexpr UInt32 kMaxWorkShards = 8;
+
+UInt32 GetNumWorkShards(UInt32 workSize)
+{
+	UInt32 numShards = std::thread::hardware_concurrency();
+	if (numShards > kMaxWorkShards)
+		numShards = kMaxWorkShards;
+	const UInt32 maxBySize = workSize / kMinItemsPerWorkShard;
+	if (numShards > maxBySize)
+		numShards = maxBySize;
+	return numShards ? numShards : 1;
+}
+
+void RunWorkShards(UInt32 numShards, const std::function<void(UInt32)> &doShard)
+{
+	if (numShards <= 1)
+	{
+		doShard(0);
+		return;
+	}
+
+	std::vector<std::exception_ptr> errors(numShards);
+	std::vector<std::thread> workers;
+	workers.reserve(numShards - 1);
+	for (UInt32 i = 1; i < numShards; i++)
+	{
+		workers.emplace_back([&, i]
+		{
+			try
+			{
+				doShard(i);
+			}
+			catch (...)
+			{
+				errors[i] = std::current_exception();
+			}
+		});
+	}
+
+	try
+	{
+		doShard(0);
+	}
+	catch (...)
+	{
+		errors[0] = std::current_exception();
+	}
+
+	for (auto &worker : workers)
+		worker.join();
+	for (auto &error : errors)
+	{
+		if (error)
+			std::rethrow_exception(error);
+	}
+}
+
 //==========================================================================
 
 bool WriteRecord(UInt32 type, UInt32 version, const void * buf, UInt32 length)
@@ -468,13 +659,13 @@ bool OpenRecord(UInt32 type, UInt32 version)
 		ASSERT(!s_chunkOpen);
 
 		s_pluginHeaderOffset = s_serializationTask.GetOffset();
-		s_serializationTask.Skip(sizeof(s_pluginHeader), false);
+		s_serializationTask.Skip(sizeof(s_pluginHeader));
 	}
 
 	FlushWriteChunk();
 
 	s_chunkHeaderOffset = s_serializationTask.GetOffset();
-	s_serializationTask.Skip(sizeof(s_chunkHeader), false);
+	s_serializationTask.Skip(sizeof(s_chunkHeader));
 
 	s_pluginHeader.numChunks++;
 
@@ -494,6 +685,38 @@ bool WriteRecordData(const void * buf, UInt32 length)
 	return true;
 }
 
+void WriteRecordBatch(UInt32 type, UInt32 version, const RecordBuffer &buffer, const UInt32 *recordEnds, UInt32 numRecords)
+{
+	if (!numRecords)
+		return;
+
+	if(!s_pluginHeader.numChunks)
+	{
+		ASSERT(!s_chunkOpen);
+
+		s_pluginHeaderOffset = s_serializationTask.GetOffset();
+		s_serializationTask.Skip(sizeof(s_pluginHeader));
+	}
+
+	FlushWriteChunk();
+
+	const UInt32 batchSize = numRecords * sizeof(ChunkHeader) + buffer.Size();
+	s_serializationTask.Reserve(batchSize);
+
+	ChunkHeader header = {type, version, 0};
+	UInt32 recordStart = 0;
+	for (UInt32 i = 0; i < numRecords; i++)
+	{
+		header.length = recordEnds[i] - recordStart;
+		s_serializationTask.WriteBuf(&header, sizeof(header));
+		s_serializationTask.WriteBuf(buffer.Data() + recordStart, header.length);
+		recordStart = recordEnds[i];
+	}
+
+	s_pluginHeader.numChunks += numRecords;
+	s_pluginHeader.length += batchSize;
+}
+
 void WriteRecord8(UInt8 inData)
 {
 	s_serializationTask.Write8(inData);
@@ -522,7 +745,7 @@ static void FlushReadRecord(void)
 		{
 			if (!ignoreNextChunk)
 				_WARNING("plugin didn't finish reading chunk");
-			s_serializationTask.Skip(s_chunkHeader.length, true);
+			s_serializationTask.Skip(s_chunkHeader.length);
 		}
 
 		s_chunkOpen = false;
@@ -611,6 +834,18 @@ void ReadRecord64(void *outData)
 	s_serializationTask.Read64(outData);
 }
 
+const UInt8 *ReadRecordDataPtr(UInt32 *length)
+{
+	ASSERT(s_chunkOpen);
+
+	if (*length > s_chunkHeader.length)
+		*length = s_chunkHeader.length;
+
+	s_chunkHeader.length -= *length;
+
+	return s_serializationTask.ReadPtr(*length);
+}
+
 void SkipNBytes(UInt32 byteNum)
 {
 	ASSERT(s_chunkOpen);
@@ -620,7 +855,7 @@ void SkipNBytes(UInt32 byteNum)
 	if (byteNum > s_chunkHeader.length)
 		byteNum = s_chunkHeader.length;
 
-	s_serializationTask.Skip(byteNum, false);
+	s_serializationTask.Skip(byteNum);
 
 	s_chunkHeader.length -= byteNum;
 }
@@ -690,7 +925,9 @@ void HandleSaveGame(const char * path)
 		s_fileHeader.falloutVersion =	RUNTIME_VERSION;
 		s_fileHeader.numPlugins =		0;
 
-		s_serializationTask.Skip(sizeof(s_fileHeader), false);
+		s_serializationTask.Skip(sizeof(s_fileHeader));
+
+		std::vector<ChecksumEntry> checksums;
 
 		// iterate through plugins
 		_MESSAGE("saving %d plugins to %s", s_pluginCallbacks.size(), g_savePath.c_str());
@@ -729,10 +966,24 @@ void HandleSaveGame(const char * path)
 					s_serializationTask.SetOffset(curOffset);
 
 					s_fileHeader.numPlugins++;
+
+					checksums.push_back({s_pluginHeader.opcodeBase, s_serializationTask.Checksum(s_pluginHeaderOffset, curOffset - s_pluginHeaderOffset)});
 				}
 			}
 		}
 
+		// append the checksum block
+		if (!checksums.empty())
+		{
+			const UInt32 numEntries = checksums.size();
+			const ChunkHeader chunkHeader = {kChecksumChunkType, 0, (UInt32)(sizeof(numEntries) + numEntries * sizeof(ChecksumEntry))};
+			const PluginHeader pluginHeader = {kChecksumOpcodeBase, 1, (UInt32)(sizeof(chunkHeader) + chunkHeader.length)};
+			s_serializationTask.WriteBuf(&pluginHeader, sizeof(pluginHeader));
+			s_serializationTask.WriteBuf(&chunkHeader, sizeof(chunkHeader));
+			s_serializationTask.Write32(numEntries);
+			s_serializationTask.WriteN(checksums.data(), numEntries);
+		}
+
 		// write header
 		s_serializationTask.SetOffset(0);
 		s_serializationTask.WriteBuf(&s_fileHeader, sizeof(s_fileHeader));
@@ -777,6 +1028,39 @@ void ShowCosaveWarning()
 	DisplayMessage(msg.c_str());
 }
 
+// looks for the checksum block, walking the plugin headers from the current offset; leaves the offset unchanged
+static void ReadChecksums(std::vector<ChecksumEntry> &checksums)
+{
+	const UInt32 startOffset = s_serializationTask.GetOffset();
+	PluginHeader pluginHeader;
+	while (s_serializationTask.GetRemain() >= sizeof(pluginHeader))
+	{
+		s_serializationTask.ReadBuf(&pluginHeader, sizeof(pluginHeader));
+		if (!pluginHeader.length || (pluginHeader.length > s_serializationTask.GetRemain()))
+			break;
+		if (pluginHeader.opcodeBase == kChecksumOpcodeBase)
+		{
+			if (pluginHeader.length < sizeof(ChunkHeader) + sizeof(UInt32))
+				break;
+			ChunkHeader chunkHeader;
+			s_serializationTask.ReadBuf(&chunkHeader, sizeof(chunkHeader));
+			if ((chunkHeader.type == kChecksumChunkType) && (chunkHeader.length >= sizeof(UInt32)) &&
+				(chunkHeader.length <= pluginHeader.length - sizeof(ChunkHeader)))
+			{
+				const UInt32 numEntries = s_serializationTask.Read32();
+				if (numEntries <= (chunkHeader.length - sizeof(UInt32)) / sizeof(ChecksumEntry))
+				{
+					checksums.resize(numEntries);
+					s_serializationTask.ReadBuf(checksums.data(), numEntries * sizeof(ChecksumEntry));
+				}
+			}
+			break;
+		}
+		s_serializationTask.Skip(pluginHeader.length);
+	}
+	s_serializationTask.SetOffset(startOffset);
+}
+
 void HandleLoadGame(const char * path, NVSESerializationInterface::EventCallback PluginCallbacks::* callback)
 {
 	// pass file path to plugins registered as listeners
@@ -785,6 +1069,9 @@ void HandleLoadGame(const char * path, NVSESerializationInterface::EventCallback
 	}
 
 	g_savePath = ConvertSaveFileName(path);
+	ScriptEventList::InvalidateVariableIndexes();
+	UserFunctionManager::ClearMemoizedResults(nullptr);
+	RuntimeErrorThrottle::Reset();
 
 #if _DEBUG
 	_MESSAGE("loading from %s", g_savePath.c_str());
@@ -834,11 +1121,17 @@ void HandleLoadGame(const char * path, NVSESerializationInterface::EventCallback
 		// reset flags
 		for (PluginCallbackList::iterator iter = s_pluginCallbacks.begin(); iter != s_pluginCallbacks.end(); ++iter)
 			iter->hadData = false;
+
+		// cosaves written before checksums were added have none, and are loaded unverified
+		std::vector<ChecksumEntry> checksums;
+		ReadChecksums(checksums);
+		UInt32 pluginBlockIdx = 0;
 			
 		NVSESerializationInterface::EventCallback curCallback = NULL;
 		// iterate through plugin data chunks
 		while (s_serializationTask.GetRemain() >= sizeof(PluginHeader))
 		{
+			const UInt32 pluginHeaderStart = s_serializationTask.GetOffset();
 			s_serializationTask.ReadBuf(&s_pluginHeader, sizeof(s_pluginHeader));
 			if (!s_pluginHeader.length)
 			{
@@ -848,6 +1141,31 @@ void HandleLoadGame(const char * path, NVSESerializationInterface::EventCallback
 
 			UInt32 pluginChunkStart = s_serializationTask.GetOffset();
 
+			if (s_pluginHeader.opcodeBase == kChecksumOpcodeBase)
+			{
+				s_serializationTask.SetOffset(pluginChunkStart + s_pluginHeader.length);
+				continue;
+			}
+
+			if (s_pluginHeader.length > s_serializationTask.GetRemain())
+			{
+				_ERROR("HandleLoadGame: plugin data (opcode base %08X) runs past the end of the cosave, stopping", s_pluginHeader.opcodeBase);
+				break;
+			}
+
+			// verify the block before any callback gets to read it; a corrupted block is skipped as if it was never saved
+			if (pluginBlockIdx < checksums.size())
+			{
+				const ChecksumEntry &entry = checksums[pluginBlockIdx++];
+				if (entry.opcodeBase == s_pluginHeader.opcodeBase &&
+					entry.crc != s_serializationTask.Checksum(pluginHeaderStart, sizeof(PluginHeader) + s_pluginHeader.length))
+				{
+					_ERROR("HandleLoadGame: cosave data for plugin (opcode base %08X) failed its checksum and was skipped", s_pluginHeader.opcodeBase);
+					s_serializationTask.SetOffset(pluginChunkStart + s_pluginHeader.length);
+					continue;
+				}
+			}
+
 			// find the corresponding plugin
 			UInt32 pluginIdx = (s_pluginHeader.opcodeBase == kNvseOpcodeBase) ? 0 : g_pluginManager.LookupHandleFromBaseOpcode(s_pluginHeader.opcodeBase);
 			if (pluginIdx != kPluginHandle_Invalid)
@@ -865,7 +1183,7 @@ void HandleLoadGame(const char * path, NVSESerializationInterface::EventCallback
 					// ### wtf?
 					_WARNING("plugin has data in save file but no handler");
 
-					s_serializationTask.Skip(s_pluginHeader.length, true);
+					s_serializationTask.Skip(s_pluginHeader.length);
 				}
 			}
 			else
@@ -873,7 +1191,7 @@ void HandleLoadGame(const char * path, NVSESerializationInterface::EventCallback
 				// ### TODO: save the data temporarily?
 				_WARNING("data in save file for plugin, but plugin isn't loaded");
 
-				s_serializationTask.Skip(s_pluginHeader.length, true);
+				s_serializationTask.Skip(s_pluginHeader.length);
 			}
 
 			UInt32 expectedOffset = pluginChunkStart + s_pluginHeader.length;
@@ -960,6 +1278,9 @@ void HandleRenameGame(const char * oldPath, const char * newPath)
 
 void HandleNewGame(void)
 {
+	ScriptEventList::InvalidateVariableIndexes();
+	UserFunctionManager::ClearMemoizedResults(nullptr);
+	RuntimeErrorThrottle::Reset();
 	PluginManager::Dispatch_Message(0, NVSEMessagingInterface::kMessage_NewGame, NULL, 0, NULL);
 	// iterate through plugins
 	for(UInt32 i = 0; i < s_pluginCallbacks.size(); i++)
@@ -971,6 +1292,41 @@ void HandleNewGame(void)
 	}
 }
 
+#if _DEBUG && RUNTIME
+bool RunLoadSkipTest()
+{
+	// two chunks: the first is skipped into and left half-read, the second must still line up
+	struct TestChunk
+	{
+		ChunkHeader	header;
+		UInt32		data[3];
+	};
+	const TestChunk image[2] =
+	{
+		{{'TST1', 1, 12}, {1, 2, 0xC0FFEE}},
+		{{'TST2', 1, 12}, {0xBEEF, 3, 4}},
+	};
+
+	const PluginHeader savedPluginHeader = s_pluginHeader;
+	s_pluginHeader.numChunks = 2;
+	s_chunkOpen = false;
+	s_serializationTask.LoadFromMemory(image, sizeof(image));
+
+	UInt32 type, version, length;
+	bool passed = GetNextRecordInfo(&type, &version, &length) && type == 'TST1' && ReadRecord32() == 1;
+	SkipNBytes(4);
+	passed = passed && ReadRecord32() == 0xC0FFEE;
+	passed = passed && GetNextRecordInfo(&type, &version, &length) && type == 'TST2' && ReadRecord32() == 0xBEEF;
+	SkipNBytes(8);
+	passed = passed && !s_chunkHeader.length && !GetNextRecordInfo(&type, &version, &length);
+
+	s_chunkOpen = false;
+	s_pluginHeader = savedPluginHeader;
+	s_serializationTask.Unload();
+	return passed;
+}
+#endif
+
 }
 
 NVSESerializationInterface	g_NVSESerializationInterface =
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <type_traits>
 #include <unordered_set>
+#include <vector>
 
 #include "PluginAPI.h"
 
@@ -21,30 +24,72 @@ namespace Serialization
 struct SerializationTask
 {
 private:
+	// loading: the whole cosave in one flat buffer
 	std::unique_ptr<UInt8[]> bufferStart;
 	UInt8		*bufferPtr;
 	UInt32		bufferSize;
 	UInt32      length;
+
+	// saving: a chain of segments, each at least twice as large as the previous one
+	// growing appends a segment and never moves data that was already written
+	struct Segment
+	{
+		std::unique_ptr<UInt8[]>	data;
+		UInt32						start;	// offset of data[0] in the cosave
+		UInt32						size;
+	};
+	std::vector<Segment>	segments;
+	UInt32		segmentIdx;		// segment holding the write offset
+	UInt8		*writePtr;
+	UInt8		*writeEnd;
+	bool		saving;
+
+	void AddSegment(UInt32 minSize);
+	void NextSegment(UInt32 minSize);
+	void WriteSlow(const void *inData, UInt32 size);
+	void SkipWrite(UInt32 size);
+
+	template <typename T>
+	void WritePOD(const T &inData)
+	{
+		if ((UInt32)(writeEnd - writePtr) >= sizeof(T))
+		{
+			*(T*)writePtr = inData;
+			writePtr += sizeof(T);
+		}
+		else WriteSlow(&inData, sizeof(T));
+	}
+
 public:
-	SerializationTask() : bufferStart(nullptr), bufferPtr(nullptr), bufferSize(0), length(0) {}
+	SerializationTask() : bufferStart(nullptr), bufferPtr(nullptr), bufferSize(0), length(0), segmentIdx(0),
+		writePtr(nullptr), writeEnd(nullptr), saving(false) {}
 
 	void PrepareSave();
 	bool Save();
 	bool Load();
+	// loads a cosave image from memory instead of the save file, e.g. for unit tests
+	void LoadFromMemory(const void *data, UInt32 size);
 	void Unload();
 
 	UInt32 GetOffset() const;
 	void SetOffset(UInt32 offset);
 
-	void Skip(UInt32 size, bool read);
+	// moves the read cursor while loading, the write cursor while saving
+	void Skip(UInt32 size);
 
-	void Write8(UInt8 inData);
-	void Write16(UInt16 inData);
-	void Write32(UInt32 inData);
-	void Write64(const void *inData);
+	void Write8(UInt8 inData) {WritePOD(inData);}
+	void Write16(UInt16 inData) {WritePOD(inData);}
+	void Write32(UInt32 inData) {WritePOD(inData);}
+	void Write64(const void *inData) {WritePOD(*(const double*)inData);}
 	void WriteBuf(const void *inData, UInt32 size);
-	void Resize(UInt32 size);
-	void CheckResize(UInt32 size);
+	template <typename T>
+	void WriteN(const T *inData, UInt32 count)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		WriteBuf(inData, count * sizeof(T));
+	}
+	// makes the next size bytes contiguous so a batch of small writes takes the fast path
+	void Reserve(UInt32 size);
 
 	UInt8 Read8();
 	UInt16 Read16();
@@ -53,11 +98,116 @@ public:
 	void ReadBuf(void *outData, UInt32 size);
 
 	void PeekBuf(void *outData, UInt32 size);
+	const UInt8 *ReadPtr(UInt32 size);
 
 	UInt32 GetRemain() const {return length - GetOffset();}
 	void ValidateOffset(UInt32 size) const;
+
+	// CRC-32C of size bytes starting at offset, in whichever buffer is active
+	UInt32 Checksum(UInt32 offset, UInt32 size) const;
+};
+
+// growable byte buffer for encoding records away from the serialization task (e.g. on a worker thread)
+// the encoded bytes are appended to the cosave afterwards with WriteRecordData
+class RecordBuffer
+{
+	UInt8		*data;
+	UInt32		size;
+	UInt32		alloc;
+
+	UInt8 *Grow(UInt32 count);
+
+public:
+	RecordBuffer() : data(nullptr), size(0), alloc(0) {}
+	RecordBuffer(RecordBuffer &&other) noexcept : data(other.data), size(other.size), alloc(other.alloc)
+	{
+		other.data = nullptr;
+		other.size = other.alloc = 0;
+	}
+	~RecordBuffer() {free(data);}
+
+	RecordBuffer(const RecordBuffer &other) = delete;
+	RecordBuffer& operator=(const RecordBuffer &other) = delete;
+
+	const UInt8 *Data() const {return data;}
+	UInt32 Size() const {return size;}
+	void Reserve(UInt32 count);
+
+	void Write8(UInt8 inData) {*Grow(1) = inData;}
+	void Write16(UInt16 inData) {*(UInt16*)Grow(2) = inData;}
+	void Write32(UInt32 inData) {*(UInt32*)Grow(4) = inData;}
+	void Write64(const void *inData) {*(double*)Grow(8) = *(const double*)inData;}
+	void WriteBuf(const void *inData, UInt32 length)
+	{
+		if (length) memcpy(Grow(length), inData, length);
+	}
+	template <typename T>
+	void Write(const T &inData)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		*(T*)Grow(sizeof(T)) = inData;
+	}
+	template <typename T>
+	void WriteN(const T *inData, UInt32 count)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		WriteBuf(inData, count * sizeof(T));
+	}
 };
 
+// reads back record data obtained with ReadRecordDataPtr; running out of data behaves like the ReadRecord* functions
+class RecordReader
+{
+	const UInt8		*pos;
+	const UInt8		*end;
+
+public:
+	RecordReader() : pos(nullptr), end(nullptr) {}
+	RecordReader(const UInt8 *data, UInt32 length) : pos(data), end(data + length) {}
+
+	UInt32 Remain() const {return end - pos;}
+
+	UInt8 Read8()
+	{
+		if (pos == end) return 0;
+		return *pos++;
+	}
+	UInt16 Read16()
+	{
+		if (Remain() < 2) return 0;
+		UInt16 result = *(const UInt16*)pos;
+		pos += 2;
+		return result;
+	}
+	UInt32 Read32()
+	{
+		if (Remain() < 4) return 0;
+		UInt32 result = *(const UInt32*)pos;
+		pos += 4;
+		return result;
+	}
+	void Read64(void *outData)
+	{
+		if (Remain() < 8) return;
+		*(double*)outData = *(const double*)pos;
+		pos += 8;
+	}
+	UInt32 ReadBuf(void *outData, UInt32 length)
+	{
+		if (length > Remain())
+			length = Remain();
+		memcpy(outData, pos, length);
+		pos += length;
+		return length;
+	}
+};
+
+// number of shards worth splitting workSize items into, 1 if the work is too small to be split
+UInt32	GetNumWorkShards(UInt32 workSize);
+// calls doShard(i) for each shard in [0, numShards), shard 0 on the calling thread and the rest on worker threads
+// rethrows the first exception thrown by any shard once all of them are done
+void	RunWorkShards(UInt32 numShards, const std::function<void(UInt32)> &doShard);
+
 struct PluginCallbacks
 {
 	PluginCallbacks()
@@ -85,6 +235,15 @@ void	WriteRecord8(UInt8 inData);
 void	WriteRecord16(UInt16 inData);
 void	WriteRecord32(UInt32 inData);
 void	WriteRecord64(const void *inData);
+template <typename T>
+void	WriteRecordN(const T *inData, UInt32 count)
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+	WriteRecordData(inData, count * sizeof(T));
+}
+// writes numRecords complete records of the same type, record i being buffer bytes [recordEnds[i - 1], recordEnds[i])
+// equivalent to OpenRecord + WriteRecordData for each, but reserves the space once and writes the headers directly
+void	WriteRecordBatch(UInt32 type, UInt32 version, const RecordBuffer &buffer, const UInt32 *recordEnds, UInt32 numRecords);
 
 bool	GetNextRecordInfo(UInt32 * type, UInt32 * version, UInt32 * length);
 UInt32	ReadRecordData(void * buf, UInt32 length);
@@ -94,6 +253,10 @@ UInt16	ReadRecord16();
 UInt32	ReadRecord32();
 void	ReadRecord64(void *outData);
 
+// internal: consumes up to length bytes of the current record and returns a pointer to them in the load buffer
+// the data stays valid until the load callback returns
+const UInt8 *ReadRecordDataPtr(UInt32 *length);
+
 void	SkipNBytes(UInt32 byteNum);
 
 bool	ResolveRefID(UInt32 refID, UInt32 * outRefID);
@@ -113,6 +276,11 @@ void	InternalSetNewGameCallback(PluginHandle plugin, NVSESerializationInterface:
 void	InternalSetPreLoadCallback(PluginHandle plugin, NVSESerializationInterface::EventCallback callback);
 
 const char * GetSavePath(void);
+
+#if _DEBUG && RUNTIME
+// loads a hand-built cosave image and checks that skipping inside a chunk keeps later reads aligned
+bool RunLoadSkipTest();
+#endif
 extern bool ignoreNextChunk;
 
 }
@@ -8,6 +8,7 @@
 #include "GameData.h"
 #include "GameApi.h"
 #include <set>
+#include <vector>
 
 #include "Core_Serialization.h"
 
@@ -17,6 +18,15 @@ StringVar::StringVar(const char* in_data, UInt8 modIndex)
 	owningModIndex = modIndex;
 }
 
+StringVar::StringVar(const char* in_data, UInt32 dataLength, UInt8 modIndex) : data(in_data, dataLength),
+                                                                             owningModIndex(modIndex)
+{
+}
+
+StringVar::StringVar(std::string&& in_data, UInt8 modIndex) : data(std::move(in_data)), owningModIndex(modIndex)
+{
+}
+
 StringVar::StringVar(StringVar&& other) noexcept: data(std::move(other.data)),
                                                   owningModIndex(other.owningModIndex)
 {
@@ -30,7 +40,12 @@ StringVarMap* StringVarMap::GetSingleton()
 void StringVarMap::Delete(UInt32 varID)
 {
 	if (!IsFunctionResultCacheString(varID))
+	{
+		ScopedLock lock(cs);
+		if (StringVar* var = Get(varID))
+			RecycleBuffer(var->StringRef());
 		VarMap<StringVar>::Delete(varID);
+	}
 	else
 	{
 #if _DEBUG
@@ -81,62 +96,39 @@ void StringVar::Insert(const char* subString, UInt32 insertionPos)
 		data.append(subString);
 }
 
-#pragma warning(disable : 4996)	// disable checked iterator warning for std::transform with char*
 UInt32 StringVar::Find(char* subString, UInt32 startPos, UInt32 numChars, bool bCaseSensitive)
 {
-	UInt32 pos = -1;
-
-	if (numChars + startPos >= GetLength())
+	if (startPos >= GetLength())
+		return -1;
+	if (numChars > GetLength() - startPos)
 		numChars = GetLength() - startPos;
 
-	if (startPos < GetLength())
-	{
-		std::string source = data.substr(startPos, numChars);
-		if (!bCaseSensitive)
-		{
-			std::transform(source.begin(), source.end(), source.begin(), tolower);
-			std::transform(subString, subString + strlen(subString), subString, tolower);
-		}
-
-		 //pos = data.substr(startPos, numChars).find(subString);	//returns -1 if not found
-		pos = source.find(subString);
-		if (pos != -1)
-			pos += startPos;
-	}
-
-	return pos;
+	const char* found = FindSubStr(data.c_str() + startPos, numChars, subString, StrLen(subString), bCaseSensitive);
+	return found ? found - data.c_str() : -1;
 }
 
 UInt32 StringVar::Count(char* subString, UInt32 startPos, UInt32 numChars, bool bCaseSensitive)
 {
-	if (numChars + startPos >= GetLength())
-		numChars = GetLength() - startPos;
-
 	if (startPos >= GetLength())
 		return 0;
+	if (numChars > GetLength() - startPos)
+		numChars = GetLength() - startPos;	//only count occurences beginning before endPos
 
-	std::string source = data.substr(startPos, numChars);	//only count occurences beginning before endPos
-	UInt32 subStringLen = strlen(subString);
+	const UInt32 subStringLen = StrLen(subString);
 	if (!subStringLen)
 		return 0;
 
-	if (!bCaseSensitive)
-	{
-		std::transform(source.begin(), source.end(), source.begin(), tolower);
-		std::transform(subString, subString + strlen(subString), subString, tolower);
-	}
-
-	UInt32 strIdx = 0;
+	const char* srcStr = data.c_str() + startPos;
+	const char* srcEnd = srcStr + numChars;
 	UInt32 count = 0;
-	while (strIdx < GetLength() && ((strIdx = source.find(subString, strIdx)) != -1))
+	while (const char* found = FindSubStr(srcStr, srcEnd - srcStr, subString, subStringLen, bCaseSensitive))
 	{
 		count++;
-		strIdx += subStringLen;
+		srcStr = found + subStringLen;
 	}
 
 	return count;
 }
-#pragma warning(default : 4996)
 
 UInt32 StringVar::GetLength()
 {
@@ -148,58 +140,36 @@ UInt32 StringVar::Replace(const char* toReplace, const char* replaceWith, UInt32
 	// calc length of substring
 	if (startPos >= GetLength())
 		return 0;
-	else if (numChars + startPos > GetLength())
+	else if (numChars > GetLength() - startPos)
 		numChars = GetLength() - startPos;
 
-	UInt32 numReplaced = 0;
-	UInt32 replacementLen = strlen(replaceWith);
-	UInt32 toReplaceLen = strlen(toReplace);
-
-	// create substring
-	std::string srcStr = data.substr(startPos, numChars);
+	const UInt32 toReplaceLen = StrLen(toReplace);
+	if (!toReplaceLen)
+		return 0;
+	const UInt32 replacementLen = StrLen(replaceWith);
 
-	// remove substring from original string
-	data.erase(startPos, numChars);
+	// find the first match before building anything, most calls replace nothing
+	const char* srcStr = data.c_str() + startPos;
+	const char* srcEnd = srcStr + numChars;
+	const char* found = numToReplace ? FindSubStr(srcStr, numChars, toReplace, toReplaceLen, bCaseSensitive) : nullptr;
+	if (!found)
+		return 0;
 
-	UInt32 strIdx = 0;
-	while (numReplaced < numToReplace)// && (strIdx = srcStr.find(toReplace, strIdx)) != -1)
+	// build the result in a single pass, copying the text between matches
+	std::string result;
+	result.reserve(data.length() + (replacementLen > toReplaceLen ? replacementLen - toReplaceLen : 0));
+	result.append(data.c_str(), startPos);
+	UInt32 numReplaced = 0;
+	do
 	{
-		if (bCaseSensitive)
-		{
-			strIdx = srcStr.find(toReplace, strIdx);
-			if (strIdx == -1)
-				break;
-		}
-		else
-		{
-			std::string strToReplace = toReplace;
-			std::string::iterator iter = std::search(srcStr.begin() + strIdx, srcStr.end(), strToReplace.begin(), strToReplace.end(), ci_equal);
-			if (iter != srcStr.end())
-				strIdx = iter - srcStr.begin();
-			else
-				break;
-		}
-
-		numReplaced++;
-		srcStr.erase(strIdx, toReplaceLen);
-		if (strIdx == srcStr.length())
-		{
-			srcStr.append(replaceWith);
-			break;						// reached end of string so all done
-		}
-		else
-		{
-			srcStr.insert(strIdx, replaceWith);
-			strIdx += replacementLen;
-		}
+		result.append(srcStr, found - srcStr);
+		result.append(replaceWith, replacementLen);
+		srcStr = found + toReplaceLen;
 	}
+	while (++numReplaced < numToReplace && (found = FindSubStr(srcStr, srcEnd - srcStr, toReplace, toReplaceLen, bCaseSensitive)));
+	result.append(srcStr, data.c_str() + data.length() - srcStr);
 
-	// paste altered string back into original string
-	if (startPos == GetLength())
-		data.append(srcStr);
-	else
-		data.insert(startPos, srcStr);
-
+	data = std::move(result);
 	return numReplaced;
 }
 
@@ -273,6 +243,9 @@ void StringVarMap::Save(NVSESerializationInterface* intfc)
 
 	Serialization::OpenRecord('STVS', 0);
 
+	// gather in map order so the output matches a plain serial walk over vars
+	std::vector<std::pair<UInt32, StringVar*>> toSave;
+	toSave.reserve(vars.Size());
 	for (auto iter = vars.Begin(); !iter.End(); ++iter)
 	{
 		if (IsTemporary(iter.Key()))	// don't save temp strings
@@ -280,14 +253,49 @@ void StringVarMap::Save(NVSESerializationInterface* intfc)
 		StringVar* var = &iter.Get();
 		if (var->GetOwningModIndex() == 0xFF)
 			continue; // do not save function result cache
-		Serialization::OpenRecord('STVR', 0);
-		Serialization::WriteRecord8(var->GetOwningModIndex());
-		Serialization::WriteRecord32(iter.Key());
-		UInt16 len = var->GetLength();
-		Serialization::WriteRecord16(len);
-		Serialization::WriteRecordData(var->GetCString(), len);
+		toSave.emplace_back(iter.Key(), var);
 	}
 
+#pragma pack(push, 1)
+	struct RecordHeader
+	{
+		UInt8 modIndex;
+		UInt32 stringID;
+		UInt16 length;
+	};
+#pragma pack(pop)
+	STATIC_ASSERT(sizeof(RecordHeader) == 7);
+
+	// encode contiguous shards into their own buffers, then emit the records in order
+	struct Shard
+	{
+		Serialization::RecordBuffer buffer;
+		std::vector<UInt32> recordEnds;
+	};
+	const UInt32 numVars = toSave.size();
+	const UInt32 numShards = Serialization::GetNumWorkShards(numVars);
+	const UInt32 varsPerShard = (numVars + numShards - 1) / numShards;
+	std::vector<Shard> shards(numShards);
+
+	Serialization::RunWorkShards(numShards, [&](UInt32 shardIdx)
+	{
+		Shard& shard = shards[shardIdx];
+		const UInt32 begin = min(shardIdx * varsPerShard, numVars);
+		const UInt32 end = min(begin + varsPerShard, numVars);
+		shard.recordEnds.reserve(end - begin);
+		for (UInt32 i = begin; i < end; i++)
+		{
+			StringVar* var = toSave[i].second;
+			const RecordHeader header = {var->GetOwningModIndex(), toSave[i].first, (UInt16)var->GetLength()};
+			shard.buffer.Write(header);
+			shard.buffer.WriteBuf(var->GetCString(), header.length);
+			shard.recordEnds.push_back(shard.buffer.Size());
+		}
+	});
+
+	for (const Shard& shard : shards)
+		Serialization::WriteRecordBatch('STVR', 0, shard.buffer, shard.recordEnds.data(), shard.recordEnds.size());
+
 	Serialization::OpenRecord('STVE', 0);
 }
 
@@ -299,9 +307,7 @@ void StringVarMap::Load(NVSESerializationInterface* intfc)
 {
 	_MESSAGE("Loading strings");
 	UInt32 type, length, version, stringID, tempRefID;
-	UInt16 strLength;
 	UInt8 modIndex;
-	char buffer[kMaxMessageLength];
 
 	Clean();
 
@@ -346,13 +352,20 @@ void StringVarMap::Load(NVSESerializationInterface* intfc)
 			}
 			modIndex = tempRefID >> 24;
 
-			stringID = Serialization::ReadRecord32();
-			strLength = Serialization::ReadRecord16();
-			
-			Serialization::ReadRecordData(buffer, strLength);
-			buffer[strLength] = 0;
-
-			Insert(stringID, buffer, modIndex);
+			{
+				// construct straight from the load buffer rather than bouncing through a stack copy
+				stringID = Serialization::ReadRecord32();
+				UInt32 dataLength = Serialization::ReadRecord16();
+				const auto* strData = reinterpret_cast<const char*>(Serialization::ReadRecordDataPtr(&dataLength));
+
+				if (!IsValidID(stringID))
+				{
+					_MESSAGE("String ID %d is out of range, the cosave may be corrupt. Discarding", stringID);
+					continue;
+				}
+				// strings used to be read as C strings, keep ending them at the first NUL
+				Insert(stringID, strData, strnlen(strData, dataLength), modIndex);
+			}
 #if !_DEBUG
 			modVarCounts[modIndex] += 1;
 			if (modVarCounts[modIndex] == varCountThreshold) {
@@ -369,10 +382,35 @@ void StringVarMap::Load(NVSESerializationInterface* intfc)
 	}
 }
 
+std::string StringVarMap::TakeBuffer(const char* data)
+{
+	std::string buffer;
+	const UInt32 length = StrLen(data);
+	if (length > kInlineCapacity)
+	{
+		ScopedLock lock(cs);
+		if (!spareBuffers.empty())
+		{
+			buffer = std::move(spareBuffers.back());
+			spareBuffers.pop_back();
+		}
+	}
+	buffer.assign(data, length);
+	return buffer;
+}
+
+void StringVarMap::RecycleBuffer(std::string& buffer)
+{
+	if (buffer.capacity() <= kInlineCapacity || buffer.capacity() > kMaxSpareCapacity || spareBuffers.size() >= kMaxSpareBuffers)
+		return;
+	buffer.clear();
+	spareBuffers.push_back(std::move(buffer));
+}
+
 UInt32	StringVarMap::Add(UInt8 varModIndex, const char* data, bool bTemp, StringVar** svOut)
 {
 	UInt32 varID = GetUnusedID();
-	auto* sv = Insert(varID, data, varModIndex);
+	auto* sv = Insert(varID, TakeBuffer(data), varModIndex);
 	if (svOut)
 		*svOut = sv;
 	if (bTemp)
@@ -504,6 +542,9 @@ void StringVarMap::Reset()
 {
 	VarMap<StringVar>::Reset();
 	ResetFunctionResultStringCache();
+	ScopedLock lock(cs);
+	spareBuffers.clear();
+	spareBuffers.shrink_to_fit();
 }
 
 namespace PluginAPI
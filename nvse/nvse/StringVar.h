@@ -2,6 +2,7 @@
 #include "Serialization.h"
 #include "GameAPI.h"
 #include "VarMap.h"
+#include <vector>
 
 // String changes layout:
 //
@@ -23,6 +24,8 @@ class StringVar
 	UInt8		owningModIndex;
 public:
 	StringVar(const char* in_data, UInt8 modIndex);
+	StringVar(const char* in_data, UInt32 dataLength, UInt8 modIndex);
+	StringVar(std::string&& in_data, UInt8 modIndex);
 
 	StringVar(const StringVar& other) = delete;
 
@@ -52,7 +55,7 @@ public:
 	static UInt32	GetCharType(char ch);
 	void Trim();
 
-	std::string String()					{	return data;	}
+	const std::string& String() const		{	return data;	}
 	std::string& StringRef() {return data;}
 	const char*	GetCString();
 	UInt32		GetLength();
@@ -69,6 +72,16 @@ enum {
 
 class StringVarMap : public VarMap<StringVar>
 {
+	// Heap buffers of deleted strings, reused by new ones so the temporaries scripts create and Clean() collects
+	// every frame don't each go through the allocator. Strings short enough for std::string's inline buffer never need one.
+	static constexpr UInt32 kInlineCapacity = 15;	// chars MSVC's std::string holds without allocating
+	static constexpr UInt32 kMaxSpareBuffers = 0x80;
+	static constexpr UInt32 kMaxSpareCapacity = 0x400;
+	std::vector<std::string> spareBuffers;
+
+	std::string TakeBuffer(const char* data);
+	void RecycleBuffer(std::string& buffer);
+
 public:
 	void Save(NVSESerializationInterface* intfc);
 	void Load(NVSESerializationInterface* intfc);
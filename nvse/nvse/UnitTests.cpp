@@ -3,6 +3,7 @@
 #include "UnitTests.h"
 #include "GameAPI.h"
 #include "FunctionScripts.h"
+#include "Serialization.h"
 #include <fstream>
 #include <string>
 #include <sstream>
@@ -27,6 +28,8 @@ void RunUnitTests()
 		auto const script = CompileScript(str.c_str());
 		PluginAPI::CallFunctionScriptAlt(script, nullptr, 0);
 	}
+	if (!Serialization::RunLoadSkipTest())
+		Console_Print("Serialization unit test failed: skipping inside a chunk misaligned later reads.");
 	Console_Print("Finished running xNVSE script unit tests.");
 }
 
@@ -439,6 +439,82 @@ UInt32 Tokenizer::PrevToken(std::string& outStr)
 	return start + 1;
 }
 
+// membership bits of a set of delimiter chars
+struct DelimiterSet
+{
+	UInt32	bits[8];
+
+	DelimiterSet(const char *delims) : bits()
+	{
+		for (; *delims; delims++)
+			bits[*(UInt8*)delims >> 5] |= 1 << (*delims & 0x1F);
+	}
+
+	UInt32 Contains(UInt8 chr) const {return (bits[chr >> 5] >> (chr & 0x1F)) & 1;}
+};
+
+void SplitTokens(const char *src, UInt32 srcLen, const char *delims, Vector<TokenSpan> &outTokens)
+{
+	const DelimiterSet delimSet(delims);
+	// a few distinct delimiters are compared against 16 chars at a time, larger sets go through the lookup bits instead
+	constexpr UInt32 kMaxCompareDelims = 8;
+	__m128i compareDelims[kMaxCompareDelims];
+	UInt32 numDelims = 0;
+	bool compareChars = true;
+	for (UInt32 chr = 1; chr < 0x100; chr++)
+	{
+		if (!delimSet.Contains(chr)) continue;
+		if (numDelims == kMaxCompareDelims)
+		{
+			compareChars = false;
+			break;
+		}
+		compareDelims[numDelims++] = _mm_set1_epi8((char)chr);
+	}
+
+	// tokens start and end wherever the chars flip between delimiter and not; the start of src counts as a delimiter
+	UInt32 prevIsDelim = 1, tokenStart = 0, index = 0;
+	for (; index + 16 <= srcLen; index += 16)
+	{
+		UInt32 delimBits = 0;
+		if (compareChars)
+		{
+			const __m128i chars = _mm_loadu_si128((const __m128i*)(src + index));
+			__m128i matches = _mm_setzero_si128();
+			for (UInt32 idx = 0; idx < numDelims; idx++)
+				matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chars, compareDelims[idx]));
+			delimBits = _mm_movemask_epi8(matches);
+		}
+		else
+		{
+			for (UInt32 idx = 0; idx < 16; idx++)
+				delimBits |= delimSet.Contains(src[index + idx]) << idx;
+		}
+		UInt32 flips = (delimBits ^ ((delimBits << 1) | prevIsDelim)) & 0xFFFF;
+		prevIsDelim = delimBits >> 15;
+		while (flips)
+		{
+			unsigned long bit;
+			_BitScanForward(&bit, flips);
+			if ((delimBits >> bit) & 1)
+				outTokens.Append(TokenSpan{tokenStart, index + bit - tokenStart});
+			else tokenStart = index + bit;
+			flips &= flips - 1;
+		}
+	}
+	for (; index < srcLen; index++)
+	{
+		const UInt32 isDelim = delimSet.Contains(src[index]);
+		if (isDelim == prevIsDelim) continue;
+		if (isDelim)
+			outTokens.Append(TokenSpan{tokenStart, index - tokenStart});
+		else tokenStart = index;
+		prevIsDelim = isDelim;
+	}
+	if (!prevIsDelim)
+		outTokens.Append(TokenSpan{tokenStart, srcLen - tokenStart});
+}
+
 #if RUNTIME
 
 const char GetSeparatorChar(Script * script)
@@ -669,11 +745,155 @@ const char* GetModName(TESForm* form)
 	return modName;
 }
 #if NVSE_CORE
-void ShowRuntimeError(Script* script, const char* fmt, ...)
+namespace RuntimeErrorThrottle
 {
-	va_list args;
-	va_start(args, fmt);
+	constexpr UInt32 kWindowMs = 5000;
+
+	// keyed by the compiled code rather than the Script, lambdas get a new Script per instance but share their parent's code
+	struct SiteKey
+	{
+		const UInt8*	code;
+		UInt32			offset;
+		const void*		messageTemplate;
 
+		bool operator==(const SiteKey& rhs) const
+		{
+			return code == rhs.code && offset == rhs.offset && messageTemplate == rhs.messageTemplate;
+		}
+	};
+
+	struct Site
+	{
+		UInt32 refID = 0;			// the key's script may be gone by the time a summary is printed
+		const char* modName = nullptr;
+		UInt32 total = 0;
+		UInt32 shown = 0;
+		UInt32 shownInWindow = 0;
+		UInt32 suppressedInWindow = 0;
+		UInt32 windowStart = 0;
+		UInt32 lastSeen = 0;
+	};
+
+	ICriticalSection s_cs;
+	UnorderedMap<SiteKey, Site> s_sites;
+	UInt32 s_repeatLimit = 3;
+	UInt32 s_numSuppressedSites = 0;	// sites with suppressed errors waiting for a summary
+	UInt32 s_nextSweep = 0;
+	Stats s_retired;					// counts of the sites Update dropped
+
+	// prints how often the site's error was suppressed and starts a new window, s_cs must be held
+	static void FlushSuppressed(const SiteKey& key, Site& site, UInt32 now)
+	{
+		char summary[0x200];
+		sprintf_s(summary, sizeof(summary), "Error in script %08X in mod %s at offset 0x%04X repeated %d more times in the last %d seconds",
+			site.refID, site.modName, key.offset, site.suppressedInWindow, (now - site.windowStart) / 1000);
+		Console_Print("%s", summary);
+		_MESSAGE("%s", summary);
+		site.suppressedInWindow = 0;
+		site.windowStart = now;
+		site.shownInWindow = 0;
+		s_numSuppressedSites--;
+	}
+
+	bool Admit(Script* script, UInt32 offset, const void* messageTemplate)
+	{
+		ScopedLock lock(s_cs);
+		const SiteKey key{script ? script->data : nullptr, offset, messageTemplate};
+		Site& site = s_sites[key];
+		const UInt32 now = GetTickCount();
+		site.lastSeen = now;
+		if (!site.total)
+		{
+			site.refID = script ? script->refID : 0;
+			site.modName = GetModName(script);
+		}
+		if (!site.total || now - site.windowStart >= kWindowMs)
+		{
+			// in a continuous storm the window expires here before Update's sweep sees it
+			if (site.suppressedInWindow)
+				FlushSuppressed(key, site, now);
+			site.windowStart = now;
+			site.shownInWindow = 0;
+		}
+		site.total++;
+		if (!s_repeatLimit || site.shownInWindow < s_repeatLimit)
+		{
+			site.shownInWindow++;
+			site.shown++;
+			return true;
+		}
+		if (!site.suppressedInWindow++)
+			s_numSuppressedSites++;
+		return false;
+	}
+
+	void Update()
+	{
+		if (s_sites.Empty())
+			return;
+		const UInt32 now = GetTickCount();
+		if ((SInt32)(now - s_nextSweep) < 0)
+			return;
+		s_nextSweep = now + 1000;
+
+		ScopedLock lock(s_cs);
+		for (auto iter = s_sites.Begin(); !iter.End(); ++iter)
+		{
+			Site& site = iter.Get();
+			if (site.suppressedInWindow && now - site.windowStart >= kWindowMs)
+				FlushSuppressed(iter.Key(), site, now);
+			// a site quiet for a whole window has nothing left to throttle, drop it so the map stays bounded
+			// and a freed script's code address can't inherit its counts
+			else if (!site.suppressedInWindow && now - site.lastSeen >= kWindowMs)
+			{
+				s_retired.sites++;
+				s_retired.total += site.total;
+				s_retired.shown += site.shown;
+				iter.Remove();
+			}
+		}
+	}
+
+	void SetRepeatLimit(UInt32 limit)
+	{
+		s_repeatLimit = limit;
+	}
+
+	UInt32 GetRepeatLimit()
+	{
+		return s_repeatLimit;
+	}
+
+	Stats GetStats(Script* script)
+	{
+		ScopedLock lock(s_cs);
+		Stats stats;
+		if (!script)
+			stats = s_retired;
+		for (auto iter = s_sites.Begin(); !iter.End(); ++iter)
+		{
+			if (script && iter.Key().code != script->data)
+				continue;
+			const Site& site = iter.Get();
+			stats.sites++;
+			stats.total += site.total;
+			stats.shown += site.shown;
+		}
+		stats.suppressed = stats.total - stats.shown;
+		return stats;
+	}
+
+	void Reset()
+	{
+		ScopedLock lock(s_cs);
+		s_sites.Clear();
+		s_numSuppressedSites = 0;
+		s_retired = Stats();
+	}
+}
+
+static void vShowRuntimeError(Script* script, const char* fmt, va_list args)
+{
 	char errorMsg[0x800];
 	vsprintf_s(errorMsg, sizeof(errorMsg), fmt, args);
 	
@@ -716,7 +936,24 @@ void ShowRuntimeError(Script* script, const char* fmt, ...)
 	_MESSAGE("%s", errorHeader);
 
 	PluginManager::Dispatch_Message(0, NVSEMessagingInterface::kMessage_RuntimeScriptError, errorMsg, 4, NULL);
+}
 
+void ShowRuntimeError(Script* script, const char* fmt, ...)
+{
+	if (!RuntimeErrorThrottle::Admit(script, 0, fmt))
+		return;
+
+	va_list args;
+	va_start(args, fmt);
+	vShowRuntimeError(script, fmt, args);
+	va_end(args);
+}
+
+void ShowAdmittedRuntimeError(Script* script, const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	vShowRuntimeError(script, fmt, args);
 	va_end(args);
 }
 #endif
@@ -121,6 +121,16 @@ private:
 	std::string m_data;
 };
 
+struct TokenSpan
+{
+	UInt32	offset;
+	UInt32	length;
+};
+
+// Splits all of src at once into the tokens Tokenizer::NextToken would return one by one, appending them to outTokens.
+// Delimiters are located 16 chars at a time.
+void SplitTokens(const char *src, UInt32 srcLen, const char *delims, Vector<TokenSpan> &outTokens);
+
 #if RUNTIME
 
 const char GetSeparatorChar(Script * script);
@@ -192,6 +202,32 @@ void ShowErrorMessageBox(const char* message);
 const char* GetModName(TESForm* form);
 
 void ShowRuntimeError(Script* script, const char* fmt, ...);
+// Same as ShowRuntimeError, for callers that already passed the error through RuntimeErrorThrottle::Admit.
+void ShowAdmittedRuntimeError(Script* script, const char* fmt, ...);
+
+// Errors repeating at the same site (script, bytecode offset, message template) are shown at most a set number of
+// times per window; the rest are only counted, and a "repeated N times" line is printed when the window runs out.
+namespace RuntimeErrorThrottle
+{
+	struct Stats
+	{
+		UInt32 total = 0;		// errors raised, shown or not
+		UInt32 shown = 0;
+		UInt32 suppressed = 0;
+		UInt32 sites = 0;		// distinct sites that raised them
+	};
+
+	// counts an error at the site, returns false if it is to be suppressed
+	bool Admit(Script* script, UInt32 offset, const void* messageTemplate);
+	// prints the summaries of windows that ran out, called once per frame
+	void Update();
+	// 0 means no limit
+	void SetRepeatLimit(UInt32 limit);
+	UInt32 GetRepeatLimit();
+	// for one script's sites seen within the last window, or all errors since the game was loaded if null
+	Stats GetStats(Script* script);
+	void Reset();
+}
 
 #endif
 
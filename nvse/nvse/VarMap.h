@@ -7,15 +7,90 @@
 
 struct _VarIDs : Set<UInt32>
 {
-	UInt32 PopFirst()
+	UInt32 LastKey() {return Keys()[numKeys - 1];}
+};
+
+// hands out the lowest unused var ID in amortized constant time
+// one bit per ID marks it as used; one summary bit per 32 IDs marks the words that still have a free ID
+class _VarIDAllocator
+{
+	Vector<UInt32>	usedBits;
+	Vector<UInt32>	freeWords;
+	UInt32			firstFreeWord;	// no summary word below this one has a bit set
+
+	void Grow(UInt32 numWords)
 	{
-		UInt32 *keys = Keys(), first = *keys;
-		if (--numKeys)
-			memmove(keys, keys + 1, numKeys * 4);
-		return first;
+		while (usedBits.Size() < numWords)
+		{
+			const UInt32 wordIdx = usedBits.Size();
+			usedBits.Append(0);
+			if ((wordIdx >> 5) >= freeWords.Size())
+				freeWords.Append(0);
+			freeWords[wordIdx >> 5] |= 1 << (wordIdx & 0x1F);
+		}
 	}
 
-	UInt32 LastKey() {return Keys()[numKeys - 1];}
+public:
+	// far above the number of vars a game ever holds at once; IDs are handed out lowest first,
+	// so a larger one in a cosave is corrupt and would grow the bitmap without bound
+	static constexpr UInt32 kMaxID = 0xFFFFFF;
+
+	_VarIDAllocator() {Clear();}
+
+	void Clear()
+	{
+		usedBits.Clear();
+		freeWords.Clear();
+		firstFreeWord = 0;
+		MarkUsed(0);	// never a valid ID
+	}
+
+	bool IsUsed(UInt32 id) const
+	{
+		const UInt32 wordIdx = id >> 5;
+		return (wordIdx < usedBits.Size()) && ((usedBits[wordIdx] >> (id & 0x1F)) & 1);
+	}
+
+	void MarkUsed(UInt32 id)
+	{
+		if (id > kMaxID)
+			return;
+		const UInt32 wordIdx = id >> 5;
+		Grow(wordIdx + 1);
+		UInt32 &bits = usedBits[wordIdx];
+		bits |= 1 << (id & 0x1F);
+		if (bits == 0xFFFFFFFF)
+			freeWords[wordIdx >> 5] &= ~(1 << (wordIdx & 0x1F));
+	}
+
+	void MarkFree(UInt32 id)
+	{
+		const UInt32 wordIdx = id >> 5;
+		if (!id || (wordIdx >= usedBits.Size()))
+			return;
+		usedBits[wordIdx] &= ~(1 << (id & 0x1F));
+		freeWords[wordIdx >> 5] |= 1 << (wordIdx & 0x1F);
+		if ((wordIdx >> 5) < firstFreeWord)
+			firstFreeWord = wordIdx >> 5;
+	}
+
+	UInt32 Allocate()
+	{
+		while ((firstFreeWord < freeWords.Size()) && !freeWords[firstFreeWord])
+			firstFreeWord++;
+		UInt32 id;
+		if (firstFreeWord < freeWords.Size())
+		{
+			unsigned long bitIdx;
+			_BitScanForward(&bitIdx, freeWords[firstFreeWord]);
+			const UInt32 wordIdx = (firstFreeWord << 5) | bitIdx;
+			_BitScanForward(&bitIdx, ~usedBits[wordIdx]);
+			id = (wordIdx << 5) | bitIdx;
+		}
+		else id = usedBits.Size() << 5;
+		MarkUsed(id);
+		return id;
+	}
 };
 
 template <class Var>
@@ -29,12 +104,18 @@ protected:
 #endif
 	class VarCache
 	{
-		// if desired this can be replaced with an impl that caches more than one var without changing client code
-		UInt32		varID;
-		Var			* var;
+		// direct-mapped on the low bits of the ID, so a few vars used in turn don't keep evicting each other
+		static constexpr UInt32 kNumSlots = 0x20;
+
+		struct Slot
+		{
+			UInt32	varID;
+			Var		*var;
+		};
+		Slot	slots[kNumSlots];
 
 	public:
-		VarCache() : varID(0), var(NULL) {}
+		VarCache() {Reset();}
 
 		~VarCache()
 		{ 
@@ -43,55 +124,50 @@ protected:
 
 		void Insert(UInt32 id, Var* v)
 		{
-			varID = id;
-			var = v;
+			Slot &slot = slots[id & (kNumSlots - 1)];
+			slot.varID = id;
+			slot.var = v;
 		}
 
-		// clear all cached vars (only one in current impl)
+		// clear all cached vars
 		void Reset()
 		{
-			varID = 0;
-			var = NULL;
+			for (Slot &slot : slots)
+			{
+				slot.varID = 0;
+				slot.var = NULL;
+			}
 		}
 
 		void Remove(UInt32 id)
 		{
-			if (id == varID)
+			Slot &slot = slots[id & (kNumSlots - 1)];
+			if (slot.varID == id)
 			{
-				Reset();
+				slot.varID = 0;
+				slot.var = NULL;
 			}
 		}
 
 		Var* Get(UInt32 id)
 		{
-			return (varID == id) ? var : NULL;
+			const Slot &slot = slots[id & (kNumSlots - 1)];
+			return (slot.varID == id) ? slot.var : NULL;
 		}
 	};
 
 	_VarMap				vars;
-	_VarIDs				usedIDs;
+	_VarIDAllocator		usedIDs;		// new vars get the lowest ID not in use
 	_VarIDs				tempIDs;		// set of IDs of unreferenced vars, makes for easy cleanup
-	_VarIDs				availableIDs;	// IDs < greatest used ID available as IDs for new vars
 	VarCache			cache;
 	ICriticalSection	cs;				// trying to avoid what looks like concurrency issues
 	ICriticalSection    tempIdsCs;
 
-	void SetIDAvailable(UInt32 id)
-	{
-		if (id) availableIDs.Insert(id);
-	}
-
+	// the returned ID is reserved straight away, so concurrent callers never get the same one
 	UInt32 GetUnusedID()
 	{
-		UInt32 id = 1;
-		cs.Enter();
-
-		if (!availableIDs.Empty())
-			id = availableIDs.PopFirst();
-		else if (!usedIDs.Empty())
-			id = usedIDs.LastKey() + 1;
-		cs.Leave();
-		return id;
+		ScopedLock lock(cs);
+		return usedIDs.Allocate();
 	}
 
 public:
@@ -122,11 +198,17 @@ public:
 		return Get(varID) ? true : false;
 	}
 
+	// for IDs read from the cosave
+	static bool IsValidID(UInt32 varID)
+	{
+		return varID && (varID <= _VarIDAllocator::kMaxID);
+	}
+
 	template <typename ...Args>
 	Var* Insert(UInt32 varID, Args&& ...args)
 	{
 		cs.Enter();
-		usedIDs.Insert(varID);
+		usedIDs.MarkUsed(varID);
 		Var* var = vars.Emplace(varID, std::forward<Args>(args)...);
 		cs.Leave();
 		return var;
@@ -137,9 +219,8 @@ public:
 		cs.Enter();
 		cache.Remove(varID);
 		vars.Erase(varID);
-		usedIDs.Erase(varID);
+		usedIDs.MarkFree(varID);
 		tempIDs.Erase(varID);
-		SetIDAvailable(varID);
 		cs.Leave();
 	}
 
@@ -163,7 +244,6 @@ public:
 
 		usedIDs.Clear();
 		tempIDs.Clear();
-		availableIDs.Clear();
 	}
 
 	void MarkTemporary(UInt32 varID, bool bTemporary)
@@ -700,6 +700,21 @@ public:
 	bool Empty() const {return !numEntries;}
 	Entry *Data() const {return entries;}
 
+	void Reserve(UInt32 count)
+	{
+		if (numAlloc >= count) return;
+		// round up to a power of 2 like the bucket counts; past their cap the count is kept as is
+		const UInt32 aligned = AlignBucketCount(count);
+		if (aligned > count)
+			count = aligned;
+		if (entries)
+		{
+			count = AlignNumAlloc<Entry>(count);
+			POOL_REALLOC(entries, numAlloc, count, Entry);
+		}
+		numAlloc = count;
+	}
+
 	bool Insert(Key_Arg key, T_Data **outData)
 	{
 		if (!InsertKey(key, outData)) return false;
@@ -839,6 +854,13 @@ public:
 			else index = -1;
 		}
 
+		void Seek(Map &source, UInt32 _index)
+		{
+			table = &source;
+			index = _index;
+			pEntry = table->entries + index;
+		}
+
 		void Remove(bool frwrd = true)
 		{
 			--table->numEntries;
@@ -2030,6 +2052,17 @@ public:
 		numItems -= count;
 	}
 
+	void Reserve(UInt32 count)
+	{
+		if (numAlloc >= count) return;
+		if (data)
+		{
+			count = AlignNumAlloc<T_Data>(count);
+			POOL_REALLOC(data, numAlloc, count, T_Data);
+		}
+		numAlloc = count;
+	}
+
 	void Resize(UInt32 newSize)
 	{
 		if (numItems == newSize)
@@ -2044,9 +2077,9 @@ public:
 			}
 			else if (numAlloc < newSize)
 			{
-				newSize = AlignNumAlloc<T_Data>(newSize);
-				POOL_REALLOC(data, numAlloc, newSize, T_Data);
-				numAlloc = newSize;
+				UInt32 newAlloc = AlignNumAlloc<T_Data>(newSize);
+				POOL_REALLOC(data, numAlloc, newAlloc, T_Data);
+				numAlloc = newAlloc;
 			}
 			pData = data + numItems;
 			pEnd = data + newSize;
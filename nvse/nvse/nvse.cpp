@@ -115,6 +115,11 @@ void NVSE_Initialize(void)
 		_memmove = memmove;
 
 		gLog.SetLogLevel((IDebugLog::LogLevel)logLevel);
+#if RUNTIME
+		// log lines are written from a background thread, unless they're wanted on disk before each logging call returns
+		if (UInt32 syncLog = 0; !GetNVSEConfigOption_UInt32("RELEASE", "bSynchronousLog", &syncLog) || !syncLog)
+			gLog.SetAsync(true);
+#endif
 
 		MersenneTwister::init_genrand(GetTickCount());
 
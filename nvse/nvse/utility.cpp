@@ -1,4 +1,6 @@
 #include "nvse/utility.h"
+#include <cfloat>
+#include <cmath>
 
 memcpy_t _memcpy = memcpy, _memmove = memmove;
 
@@ -297,60 +299,138 @@ __declspec(align(16)) const UInt8 kCaseConverter[] =
 	0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF
 };
 
+static bool MatchesCI(const char *str, const char *subStr, UInt32 length)
+{
+	for (UInt32 idx = 0; idx < length; idx++)
+		if (kCaseConverter[*(UInt8*)(str + idx)] != kCaseConverter[*(UInt8*)(subStr + idx)])
+			return false;
+	return true;
+}
+
+// lower-cases the ASCII letters in 16 chars
+static __forceinline __m128i FoldCase16(__m128i chars)
+{
+	// shifts 'A'..'Z' to the bottom of the signed range, so a single signed compare picks them out
+	const __m128i shifted = _mm_add_epi8(chars, _mm_set1_epi8((char)(0x80 - 'A')));
+	const __m128i isUpper = _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(0x80 + 26)));
+	return _mm_add_epi8(chars, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+}
+
+// true if a 16-byte load from ptr stays within its 4K page
+static __forceinline bool CanLoad16(const void *ptr)
+{
+	return ((UInt32)ptr & 0xFFF) <= 0xFF0;
+}
+
 // Returns 0 if both strings are equal.
 char __fastcall StrCompare(const char *lstr, const char *rstr)
 {
 	if (!lstr) return rstr ? -1 : 0;
 	if (!rstr) return 1;
-	UInt8 lchr, rchr;
-	while (*lstr)
+	const __m128i zero = _mm_setzero_si128();
+	while (true)
 	{
-		lchr = kCaseConverter[*(UInt8*)lstr];
-		rchr = kCaseConverter[*(UInt8*)rstr];
-		if (lchr == rchr)
+		// 16 chars at a time, as long as neither load can run past the end of a string into an unmapped page
+		if (CanLoad16(lstr) && CanLoad16(rstr))
 		{
-			lstr++;
-			rstr++;
-			continue;
+			const __m128i lchars = FoldCase16(_mm_loadu_si128((const __m128i*)lstr));
+			const __m128i rchars = FoldCase16(_mm_loadu_si128((const __m128i*)rstr));
+			const UInt32 stopMask = (~_mm_movemask_epi8(_mm_cmpeq_epi8(lchars, rchars)) & 0xFFFF) | _mm_movemask_epi8(_mm_cmpeq_epi8(lchars, zero));
+			if (!stopMask)
+			{
+				lstr += 16;
+				rstr += 16;
+				continue;
+			}
+			unsigned long index;
+			_BitScanForward(&index, stopMask);
+			lstr += index;
+			rstr += index;
 		}
-		return (lchr < rchr) ? -1 : 1;
+		if (!*lstr)
+			return *rstr ? -1 : 0;
+		const UInt8 lchr = kCaseConverter[*(UInt8*)lstr], rchr = kCaseConverter[*(UInt8*)rstr];
+		if (lchr != rchr)
+			return (lchr < rchr) ? -1 : 1;
+		lstr++;
+		rstr++;
 	}
-	return *rstr ? -1 : 0;
 }
 
 void __fastcall StrToLower(char *str)
 {
 	if (!str) return;
-	UInt8 curr;
-	while (curr = *str)
+	char *end = str + StrLen(str);
+	if (end - str >= 16)
 	{
-		*str = kCaseConverter[curr];
-		str++;
+		for (; str + 16 <= end; str += 16)
+			_mm_storeu_si128((__m128i*)str, FoldCase16(_mm_loadu_si128((const __m128i*)str)));
+		// the last block overlaps the previous one, which is harmless since folding is idempotent
+		if (str != end)
+			_mm_storeu_si128((__m128i*)(end - 16), FoldCase16(_mm_loadu_si128((const __m128i*)(end - 16))));
+		return;
 	}
+	for (; str != end; str++)
+		*str = kCaseConverter[*(UInt8*)str];
 }
 
 char* __fastcall SubStrCI(const char *srcStr, const char *subStr)
 {
-	int srcLen = StrLen(srcStr);
+	const UInt32 srcLen = StrLen(srcStr);
 	if (!srcLen) return NULL;
-	int subLen = StrLen(subStr);
+	const UInt32 subLen = StrLen(subStr);
 	if (!subLen) return NULL;
-	srcLen -= subLen;
-	if (srcLen < 0) return NULL;
-	int index;
-	do
+	return const_cast<char*>(FindSubStr(srcStr, srcLen, subStr, subLen, false));
+}
+
+const char* FindSubStr(const char *srcStr, UInt32 srcLen, const char *subStr, UInt32 subLen, bool caseSensitive)
+{
+	if (!subLen) return srcStr;
+	if (subLen > srcLen) return NULL;
+
+	const UInt8 firstChr = caseSensitive ? subStr[0] : kCaseConverter[*(UInt8*)subStr];
+	const UInt8 lastChr = caseSensitive ? subStr[subLen - 1] : kCaseConverter[*(UInt8*)(subStr + subLen - 1)];
+	// first and last chars are compared already, only the ones in between are left to check on a candidate
+	const char *subMid = subStr + 1;
+	const UInt32 midLen = subLen > 2 ? subLen - 2 : 0;
+	const UInt32 lastStart = srcLen - subLen;
+	UInt32 index = 0;
+
+	// filter 16 start positions at a time on their first and last chars
+	const __m128i firstMask = _mm_set1_epi8((char)firstChr), lastMask = _mm_set1_epi8((char)lastChr);
+	for (; index + 15 <= lastStart; index += 16)
+	{
+		__m128i firstBlock = _mm_loadu_si128((const __m128i*)(srcStr + index));
+		__m128i lastBlock = _mm_loadu_si128((const __m128i*)(srcStr + index + subLen - 1));
+		if (!caseSensitive)
+		{
+			firstBlock = FoldCase16(firstBlock);
+			lastBlock = FoldCase16(lastBlock);
+		}
+		UInt32 candidates = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(firstBlock, firstMask), _mm_cmpeq_epi8(lastBlock, lastMask)));
+		while (candidates)
+		{
+			unsigned long bit;
+			_BitScanForward(&bit, candidates);
+			const char *candidate = srcStr + index + bit;
+			if (caseSensitive ? !memcmp(candidate + 1, subMid, midLen) : MatchesCI(candidate + 1, subMid, midLen))
+				return candidate;
+			candidates &= candidates - 1;
+		}
+	}
+
+	for (; index <= lastStart; index++)
 	{
-		index = 0;
-		while (true)
+		const char *candidate = srcStr + index;
+		if (caseSensitive)
 		{
-			if (kCaseConverter[*(UInt8*)(srcStr + index)] != kCaseConverter[*(UInt8*)(subStr + index)])
-				break;
-			if (++index == subLen)
-				return const_cast<char*>(srcStr);
+			if ((UInt8)candidate[0] == firstChr && (UInt8)candidate[subLen - 1] == lastChr && !memcmp(candidate + 1, subMid, midLen))
+				return candidate;
 		}
-		srcStr++;
+		else if (kCaseConverter[*(UInt8*)candidate] == firstChr && kCaseConverter[*(UInt8*)(candidate + subLen - 1)] == lastChr &&
+			MatchesCI(candidate + 1, subMid, midLen))
+			return candidate;
 	}
-	while (--srcLen >= 0);
 	return NULL;
 }
 
@@ -432,61 +512,96 @@ __declspec(naked) char* __fastcall IntToStr(char *str, int num)
 	}
 }
 
-__declspec(naked) UInt32 __fastcall StrHashCS(const char *inKey)
+// djb2 over a block of n chars is hash * 33^n + sum(c[i] * 33^(n - 1 - i)), mod 2^32, which lets 16 chars be hashed at once
+struct StrHashPowers
 {
-	__asm
+	UInt32	pow[17];		// 33^n
+	UInt32	invPow[17];		// 33^-n; 33 being odd, it is invertible mod 2^32
+	UInt16	weightsLo[16];	// 33^(15 - i), split in halves for 16-bit multiplies
+	UInt16	weightsHi[16];
+
+	constexpr StrHashPowers() : pow(), invPow(), weightsLo(), weightsHi()
 	{
-		push	esi
-		mov		eax, 0x1505
-		test	ecx, ecx
-		jz		done
-		mov		esi, ecx
-		xor		ecx, ecx
-		ALIGN 16
-	iterHead:
-		mov		cl, [esi]
-		test	cl, cl
-		jz		done
-		mov		edx, eax
-		add		eax, ecx
-		shl		edx, 5
-		add		eax, edx
-		inc		esi
-		jmp		iterHead
-	done:
-		pop		esi
-		retn
+		UInt32 inverse = 33;
+		for (UInt32 iter = 0; iter < 5; iter++)
+			inverse *= 2 - 33 * inverse;
+		pow[0] = invPow[0] = 1;
+		for (UInt32 idx = 1; idx <= 16; idx++)
+		{
+			pow[idx] = pow[idx - 1] * 33;
+			invPow[idx] = invPow[idx - 1] * inverse;
+		}
+		for (UInt32 idx = 0; idx < 16; idx++)
+		{
+			weightsLo[idx] = (UInt16)pow[15 - idx];
+			weightsHi[idx] = (UInt16)(pow[15 - idx] >> 16);
+		}
+	}
+};
+static constexpr StrHashPowers kStrHashPowers;
+
+__declspec(align(16)) static const UInt8 kLaneIndices[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+// sum(c[i] * 33^(15 - i)) over 16 chars, mod 2^32
+static __forceinline UInt32 StrHashBlock(__m128i chars)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i *weightsLo = (const __m128i*)kStrHashPowers.weightsLo, *weightsHi = (const __m128i*)kStrHashPowers.weightsHi;
+	__m128i sum = zero;
+	for (UInt32 half = 0; half < 2; half++)
+	{
+		const __m128i wordChars = half ? _mm_unpackhi_epi8(chars, zero) : _mm_unpacklo_epi8(chars, zero);
+		const __m128i wLo = _mm_loadu_si128(weightsLo + half), wHi = _mm_loadu_si128(weightsHi + half);
+		// c * w = c * wLo + ((c * wHi) << 16), where c * wLo needs its high half as well
+		const __m128i productLo = _mm_mullo_epi16(wordChars, wLo);
+		const __m128i productHi = _mm_add_epi16(_mm_mulhi_epu16(wordChars, wLo), _mm_mullo_epi16(wordChars, wHi));
+		sum = _mm_add_epi32(sum, _mm_add_epi32(_mm_unpacklo_epi16(productLo, productHi), _mm_unpackhi_epi16(productLo, productHi)));
 	}
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
 }
 
-__declspec(naked) UInt32 __fastcall StrHashCI(const char *inKey)
+template <bool kCaseInsensitive>
+static __forceinline UInt32 StrHash(const char *inKey)
 {
-	__asm
+	UInt32 hash = 0x1505;
+	if (!inKey) return hash;
+	// aligned loads never cross into the next page; lanes outside the string are zeroed so they add nothing to the sum
+	UInt32 start = (UInt32)inKey & 0xF;
+	const __m128i *block = (const __m128i*)(inKey - start);
+	const __m128i lanes = _mm_load_si128((const __m128i*)kLaneIndices);
+	__m128i inString = _mm_cmpgt_epi8(lanes, _mm_set1_epi8((char)(start - 1)));
+	while (true)
 	{
-		push	esi
-		mov		eax, 0x1505
-		test	ecx, ecx
-		jz		done
-		mov		esi, ecx
-		xor		ecx, ecx
-		ALIGN 16
-	iterHead:
-		mov		cl, [esi]
-		test	cl, cl
-		jz		done
-		mov		edx, eax
-		shl		edx, 5
-		add		eax, edx
-		movzx	edx, kCaseConverter[ecx]
-		add		eax, edx
-		inc		esi
-		jmp		iterHead
-	done:
-		pop		esi
-		retn
+		__m128i chars = _mm_load_si128(block++);
+		if (kCaseInsensitive)
+			chars = FoldCase16(chars);
+		const UInt32 nullMask = (_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_setzero_si128())) >> start) << start;
+		if (nullMask)
+		{
+			unsigned long end;
+			_BitScanForward(&end, nullMask);
+			inString = _mm_and_si128(inString, _mm_cmplt_epi8(lanes, _mm_set1_epi8((char)end)));
+			// the block sum came out scaled by 33^(16 - end), for the zeroed lanes past the end
+			return hash * kStrHashPowers.pow[end - start] + StrHashBlock(_mm_and_si128(chars, inString)) * kStrHashPowers.invPow[16 - end];
+		}
+		hash = hash * kStrHashPowers.pow[16 - start] + StrHashBlock(_mm_and_si128(chars, inString));
+		inString = _mm_cmpeq_epi8(lanes, lanes);
+		start = 0;
 	}
 }
 
+UInt32 __fastcall StrHashCS(const char *inKey)
+{
+	return StrHash<false>(inKey);
+}
+
+UInt32 __fastcall StrHashCI(const char *inKey)
+{
+	return StrHash<true>(inKey);
+}
+
 void SpinLock::Enter()
 {
 	UInt32 threadID = GetCurrentThreadId();
@@ -526,4 +641,485 @@ void SpinLock::Leave()
 {
 	if (owningThread && !--enterCount)
 		owningThread = 0;
-}
\ No newline at end of file
+}
+
+// CRC-32C (Castagnoli), reflected polynomial 0x82F63B78
+struct CRC32CTables
+{
+	UInt32	t[8][0x100];
+
+	constexpr CRC32CTables() : t()
+	{
+		for (UInt32 i = 0; i < 0x100; i++)
+		{
+			UInt32 crc = i;
+			for (UInt32 j = 0; j < 8; j++)
+				crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78 : 0);
+			t[0][i] = crc;
+		}
+		for (UInt32 i = 0; i < 0x100; i++)
+			for (UInt32 k = 1; k < 8; k++)
+				t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+	}
+};
+static constexpr CRC32CTables kCRC32CTables;
+
+// slicing-by-8 fallback for CPUs without SSE4.2
+static UInt32 CRC32C_Table(const UInt8 *data, UInt32 length, UInt32 crc)
+{
+	const auto &t = kCRC32CTables.t;
+	for (; length && ((UInt32)data & 3); length--)
+		crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+	for (; length >= 8; length -= 8, data += 8)
+	{
+		const UInt32 lo = *(const UInt32*)data ^ crc, hi = *(const UInt32*)(data + 4);
+		crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+			t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+	}
+	while (length--)
+		crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+	return crc;
+}
+
+static UInt32 CRC32C_SSE42(const UInt8 *data, UInt32 length, UInt32 crc)
+{
+	for (; length && ((UInt32)data & 3); length--)
+		crc = _mm_crc32_u8(crc, *data++);
+	for (; length >= 0x10; length -= 0x10, data += 0x10)
+	{
+		crc = _mm_crc32_u32(crc, *(const UInt32*)data);
+		crc = _mm_crc32_u32(crc, *(const UInt32*)(data + 4));
+		crc = _mm_crc32_u32(crc, *(const UInt32*)(data + 8));
+		crc = _mm_crc32_u32(crc, *(const UInt32*)(data + 0xC));
+	}
+	for (; length >= 4; length -= 4, data += 4)
+		crc = _mm_crc32_u32(crc, *(const UInt32*)data);
+	while (length--)
+		crc = _mm_crc32_u8(crc, *data++);
+	return crc;
+}
+
+static const bool s_hasSSE42 = []
+{
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 1);
+	return (cpuInfo[2] & (1 << 20)) != 0;
+}();
+
+UInt32 __fastcall CRC32C(const void *data, UInt32 length, UInt32 crc)
+{
+	crc = ~crc;
+	crc = s_hasSSE42 ? CRC32C_SSE42((const UInt8*)data, length, crc) : CRC32C_Table((const UInt8*)data, length, crc);
+	return ~crc;
+}
+
+bool g_roundTripNumberStrings = false;
+
+// Grisu2 (Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers").
+// Produces digits that always parse back to the same double, and the shortest such digits in all but a few cases.
+namespace Grisu2
+{
+	struct DiyFp
+	{
+		UInt64	f;
+		int		e;
+
+		DiyFp Sub(const DiyFp &rhs) const {return {f - rhs.f, e};}
+
+		// rounded upper half of the 128-bit product
+		DiyFp Mul(const DiyFp &rhs) const
+		{
+			UInt64 p0 = UInt64(UInt32(f)) * UInt32(rhs.f), p1 = UInt64(UInt32(f)) * UInt32(rhs.f >> 32),
+				p2 = UInt64(UInt32(f >> 32)) * UInt32(rhs.f), p3 = UInt64(UInt32(f >> 32)) * UInt32(rhs.f >> 32);
+			UInt64 mid = (p0 >> 32) + UInt32(p1) + UInt32(p2) + (1U << 31);
+			return {p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32), e + rhs.e + 64};
+		}
+
+		DiyFp Normalize() const
+		{
+			DiyFp res = *this;
+			while (!(res.f >> 63))
+			{
+				res.f <<= 1;
+				res.e--;
+			}
+			return res;
+		}
+
+		DiyFp NormalizeTo(int toExp) const {return {f << (e - toExp), toExp};}
+	};
+
+	struct CachedPower
+	{
+		UInt64	f;
+		int		e;
+		int		k;
+	};
+
+	// normalized 10^k for k = -300, -292, ..., 324
+	static const CachedPower kCachedPowers[] =
+	{
+	{0xAB70FE17C79AC6CA, -1060, -300}, {0xFF77B1FCBEBCDC4F, -1034, -292},
+	{0xBE5691EF416BD60C, -1007, -284}, {0x8DD01FAD907FFC3C, -980, -276},
+	{0xD3515C2831559A83, -954, -268}, {0x9D71AC8FADA6C9B5, -927, -260},
+	{0xEA9C227723EE8BCB, -901, -252}, {0xAECC49914078536D, -874, -244},
+	{0x823C12795DB6CE57, -847, -236}, {0xC21094364DFB5637, -821, -228},
+	{0x9096EA6F3848984F, -794, -220}, {0xD77485CB25823AC7, -768, -212},
+	{0xA086CFCD97BF97F4, -741, -204}, {0xEF340A98172AACE5, -715, -196},
+	{0xB23867FB2A35B28E, -688, -188}, {0x84C8D4DFD2C63F3B, -661, -180},
+	{0xC5DD44271AD3CDBA, -635, -172}, {0x936B9FCEBB25C996, -608, -164},
+	{0xDBAC6C247D62A584, -582, -156}, {0xA3AB66580D5FDAF6, -555, -148},
+	{0xF3E2F893DEC3F126, -529, -140}, {0xB5B5ADA8AAFF80B8, -502, -132},
+	{0x87625F056C7C4A8B, -475, -124}, {0xC9BCFF6034C13053, -449, -116},
+	{0x964E858C91BA2655, -422, -108}, {0xDFF9772470297EBD, -396, -100},
+	{0xA6DFBD9FB8E5B88F, -369, -92}, {0xF8A95FCF88747D94, -343, -84},
+	{0xB94470938FA89BCF, -316, -76}, {0x8A08F0F8BF0F156B, -289, -68},
+	{0xCDB02555653131B6, -263, -60}, {0x993FE2C6D07B7FAC, -236, -52},
+	{0xE45C10C42A2B3B06, -210, -44}, {0xAA242499697392D3, -183, -36},
+	{0xFD87B5F28300CA0E, -157, -28}, {0xBCE5086492111AEB, -130, -20},
+	{0x8CBCCC096F5088CC, -103, -12}, {0xD1B71758E219652C, -77, -4},
+	{0x9C40000000000000, -50, 4}, {0xE8D4A51000000000, -24, 12},
+	{0xAD78EBC5AC620000, 3, 20}, {0x813F3978F8940984, 30, 28},
+	{0xC097CE7BC90715B3, 56, 36}, {0x8F7E32CE7BEA5C70, 83, 44},
+	{0xD5D238A4ABE98068, 109, 52}, {0x9F4F2726179A2245, 136, 60},
+	{0xED63A231D4C4FB27, 162, 68}, {0xB0DE65388CC8ADA8, 189, 76},
+	{0x83C7088E1AAB65DB, 216, 84}, {0xC45D1DF942711D9A, 242, 92},
+	{0x924D692CA61BE758, 269, 100}, {0xDA01EE641A708DEA, 295, 108},
+	{0xA26DA3999AEF774A, 322, 116}, {0xF209787BB47D6B85, 348, 124},
+	{0xB454E4A179DD1877, 375, 132}, {0x865B86925B9BC5C2, 402, 140},
+	{0xC83553C5C8965D3D, 428, 148}, {0x952AB45CFA97A0B3, 455, 156},
+	{0xDE469FBD99A05FE3, 481, 164}, {0xA59BC234DB398C25, 508, 172},
+	{0xF6C69A72A3989F5C, 534, 180}, {0xB7DCBF5354E9BECE, 561, 188},
+	{0x88FCF317F22241E2, 588, 196}, {0xCC20CE9BD35C78A5, 614, 204},
+	{0x98165AF37B2153DF, 641, 212}, {0xE2A0B5DC971F303A, 667, 220},
+	{0xA8D9D1535CE3B396, 694, 228}, {0xFB9B7CD9A4A7443C, 720, 236},
+	{0xBB764C4CA7A44410, 747, 244}, {0x8BAB8EEFB6409C1A, 774, 252},
+	{0xD01FEF10A657842C, 800, 260}, {0x9B10A4E5E9913129, 827, 268},
+	{0xE7109BFBA19C0C9D, 853, 276}, {0xAC2820D9623BF429, 880, 284},
+	{0x80444B5E7AA7CF85, 907, 292}, {0xBF21E44003ACDD2D, 933, 300},
+	{0x8E679C2F5E44FF8F, 960, 308}, {0xD433179D9C8CB841, 986, 316},
+	{0x9E19DB92B4E31BA9, 1013, 324},
+	};
+
+	static constexpr int kAlpha = -60, kGamma = -32;
+
+	// a cached power c = 10^k such that kAlpha <= e + c.e + 64 <= kGamma
+	static const CachedPower &GetCachedPower(int e)
+	{
+		const int f = kAlpha - e - 1;
+		const int k = (f * 78913) / (1 << 18) + (f > 0);
+		return kCachedPowers[(300 + k + 7) / 8];
+	}
+
+	static void Round(char *buffer, int length, UInt64 dist, UInt64 delta, UInt64 rest, UInt64 tenK)
+	{
+		while ((rest < dist) && (delta - rest >= tenK) && ((rest + tenK < dist) || (dist - rest > rest + tenK - dist)))
+		{
+			buffer[length - 1]--;
+			rest += tenK;
+		}
+	}
+
+	static void DigitGen(char *buffer, int &length, int &decExponent, DiyFp mMinus, DiyFp w, DiyFp mPlus)
+	{
+		static const UInt32 kPow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+		UInt64 delta = mPlus.Sub(mMinus).f, dist = mPlus.Sub(w).f;
+		const int shift = -mPlus.e;
+		const UInt64 oneMask = (UInt64(1) << shift) - 1;
+		UInt32 p1 = UInt32(mPlus.f >> shift);
+		UInt64 p2 = mPlus.f & oneMask;
+
+		int n = 10;
+		while ((n > 1) && (p1 < kPow10[n - 1]))
+			n--;
+		while (n > 0)
+		{
+			const UInt32 pow10 = kPow10[--n];
+			buffer[length++] = char('0' + p1 / pow10);
+			p1 %= pow10;
+			const UInt64 rest = (UInt64(p1) << shift) + p2;
+			if (rest <= delta)
+			{
+				decExponent += n;
+				Round(buffer, length, dist, delta, rest, UInt64(pow10) << shift);
+				return;
+			}
+		}
+		int m = 0;
+		do
+		{
+			p2 *= 10;
+			buffer[length++] = char('0' + (p2 >> shift));
+			p2 &= oneMask;
+			delta *= 10;
+			dist *= 10;
+			m++;
+		}
+		while (p2 > delta);
+		decExponent -= m;
+		Round(buffer, length, dist, delta, p2, oneMask + 1);
+	}
+
+	// value must be finite and positive; the result is buffer[0, length) * 10^decExponent
+	static void Convert(double value, char *buffer, int &length, int &decExponent)
+	{
+		const UInt64 bits = *(UInt64*)&value;
+		const UInt64 fraction = bits & ((UInt64(1) << 52) - 1);
+		const int biasedExp = int(bits >> 52);
+		DiyFp v = biasedExp ? DiyFp{fraction | (UInt64(1) << 52), biasedExp - 1075} : DiyFp{fraction, -1074};
+
+		const DiyFp mPlus = DiyFp{(v.f << 1) + 1, v.e - 1}.Normalize();
+		const DiyFp mMinus = ((fraction == 0) && (biasedExp > 1) ? DiyFp{(v.f << 2) - 1, v.e - 2} : DiyFp{(v.f << 1) - 1, v.e - 1}).NormalizeTo(mPlus.e);
+		v = v.Normalize();
+
+		const CachedPower &cached = GetCachedPower(mPlus.e);
+		const DiyFp cMinusK{cached.f, cached.e};
+		const DiyFp w = v.Mul(cMinusK), wMinus = mMinus.Mul(cMinusK), wPlus = mPlus.Mul(cMinusK);
+
+		length = 0;
+		decExponent = -cached.k;
+		DigitGen(buffer, length, decExponent, {wMinus.f + 1, wMinus.e}, w, {wPlus.f - 1, wPlus.e});
+	}
+}
+
+// Lays out digits * 10^decExponent the way "%.<precision>g" does once trailing zeros are stripped.
+static char *WriteGeneralFormat(char *str, const char *digits, int numDigits, int decExponent, int precision)
+{
+	const int sciExp = numDigits + decExponent - 1;
+	if ((sciExp < -4) || (sciExp >= precision))
+	{
+		*str++ = digits[0];
+		if (numDigits > 1)
+		{
+			*str++ = '.';
+			memcpy(str, digits + 1, numDigits - 1);
+			str += numDigits - 1;
+		}
+		*str++ = 'e';
+		int absExp = sciExp;
+		if (absExp < 0)
+		{
+			*str++ = '-';
+			absExp = -absExp;
+		}
+		else
+			*str++ = '+';
+		if (absExp >= 100)
+		{
+			*str++ = '0' + absExp / 100;
+			absExp %= 100;
+		}
+		*str++ = '0' + absExp / 10;
+		*str++ = '0' + absExp % 10;
+	}
+	else if (sciExp < 0)
+	{
+		*str++ = '0';
+		*str++ = '.';
+		for (int i = sciExp + 1; i < 0; i++)
+			*str++ = '0';
+		memcpy(str, digits, numDigits);
+		str += numDigits;
+	}
+	else
+	{
+		const int numWhole = sciExp + 1;
+		if (numDigits <= numWhole)
+		{
+			memcpy(str, digits, numDigits);
+			str += numDigits;
+			for (int i = numDigits; i < numWhole; i++)
+				*str++ = '0';
+		}
+		else
+		{
+			memcpy(str, digits, numWhole);
+			str += numWhole;
+			*str++ = '.';
+			memcpy(str, digits + numWhole, numDigits - numWhole);
+			str += numDigits - numWhole;
+		}
+	}
+	*str = 0;
+	return str;
+}
+
+// Returns false for NaN/infinity, otherwise writes "0"/"-0" for zeros or the sign of a nonzero value and its Grisu2 digits.
+static bool GetShortestDigits(char *&str, double num, char *digits, int &numDigits, int &decExponent)
+{
+	const UInt64 bits = *(UInt64*)&num;
+	if ((bits & 0x7FF0000000000000) == 0x7FF0000000000000)
+		return false;
+	if (bits >> 63)
+		*str++ = '-';
+	if (!(bits << 1))
+	{
+		numDigits = 0;
+		*str++ = '0';
+		*str = 0;
+		return true;
+	}
+	Grisu2::Convert(fabs(num), digits, numDigits, decExponent);
+	while (digits[numDigits - 1] == '0')
+	{
+		numDigits--;
+		decExponent++;
+	}
+	return true;
+}
+
+char* __fastcall DblToStr(char *str, double num)
+{
+	char digits[20], *start = str;
+	int numDigits, decExponent;
+	if (!GetShortestDigits(str, num, digits, numDigits, decExponent))
+		return start + sprintf_s(start, 32, "%g", num);
+	if (!numDigits)
+		return str;
+	// subnormals have too few bits of precision for the argument below
+	if (fabs(num) < DBL_MIN)
+		return start + sprintf_s(start, 32, "%g", num);
+
+	// Round to the 6 significant digits of "%g". Any digits that round-trip are within half an ulp of the exact value,
+	// so this matches rounding the exact value unless a 7-digit halfway point lies that close, where printf decides.
+	if (numDigits > 6)
+	{
+		const char *tail = digits + 6;
+		const int tailLength = numDigits - 6;
+		if (((tailLength == 1) && (*tail == '5')) || ((tailLength >= 8) && (!strncmp(tail, "5000000", 7) || !strncmp(tail, "4999999", 7))))
+			return start + sprintf_s(start, 32, "%g", num);
+
+		decExponent += tailLength;
+		numDigits = 6;
+		if (*tail >= '5')
+		{
+			int idx = 5;
+			while ((idx >= 0) && (digits[idx] == '9'))
+				idx--;
+			if (idx < 0)
+			{
+				digits[0] = '1';
+				numDigits = 1;
+				decExponent += 6;
+			}
+			else
+			{
+				digits[idx]++;
+				numDigits = idx + 1;
+				decExponent += 5 - idx;
+			}
+		}
+		while (digits[numDigits - 1] == '0')
+		{
+			numDigits--;
+			decExponent++;
+		}
+	}
+	return WriteGeneralFormat(str, digits, numDigits, decExponent, 6);
+}
+
+char* __fastcall DblToStrRoundTrip(char *str, double num)
+{
+	char digits[20], *start = str;
+	int numDigits, decExponent;
+	if (!GetShortestDigits(str, num, digits, numDigits, decExponent))
+		return start + sprintf_s(start, 32, "%g", num);
+	if (!numDigits)
+		return str;
+	return WriteGeneralFormat(str, digits, numDigits, decExponent, 17);
+}
+
+double __fastcall StrToDbl(const char *str, char **endPtr)
+{
+	// powers of ten that are exact as doubles
+	static const double kPow10[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	const char *pos = str;
+	while ((*pos == ' ') || ((*pos >= '\t') && (*pos <= '\r')))
+		pos++;
+	const bool negative = *pos == '-';
+	if (negative || (*pos == '+'))
+		pos++;
+	// hex, inf and nan forms
+	if ((pos[0] == '0') && ((pos[1] | 0x20) == 'x'))
+		return strtod(str, endPtr);
+
+	UInt64 mantissa = 0;
+	int numDigits = 0, exponent = 0;
+	bool hasDigits = false, inexact = false;
+	for (; (*pos >= '0') && (*pos <= '9'); pos++)
+	{
+		hasDigits = true;
+		if (numDigits < 19)
+		{
+			if (mantissa || (*pos != '0'))
+			{
+				mantissa = mantissa * 10 + (*pos - '0');
+				numDigits++;
+			}
+		}
+		else
+		{
+			inexact |= *pos != '0';
+			exponent++;
+		}
+	}
+	if (*pos == '.')
+	{
+		const char *fracPos = pos + 1;
+		for (; (*fracPos >= '0') && (*fracPos <= '9'); fracPos++)
+		{
+			hasDigits = true;
+			if (numDigits < 19)
+			{
+				if (mantissa || (*fracPos != '0'))
+				{
+					mantissa = mantissa * 10 + (*fracPos - '0');
+					numDigits++;
+				}
+				exponent--;
+			}
+			else
+				inexact |= *fracPos != '0';
+		}
+		if (hasDigits)
+			pos = fracPos;
+	}
+	if (!hasDigits)
+		return strtod(str, endPtr);
+
+	if ((*pos | 0x20) == 'e')
+	{
+		const char *expPos = pos + 1;
+		const bool negExp = *expPos == '-';
+		if (negExp || (*expPos == '+'))
+			expPos++;
+		if ((*expPos >= '0') && (*expPos <= '9'))
+		{
+			int expValue = 0;
+			for (; (*expPos >= '0') && (*expPos <= '9'); expPos++)
+				if (expValue < 100000)
+					expValue = expValue * 10 + (*expPos - '0');
+			exponent += negExp ? -expValue : expValue;
+			pos = expPos;
+		}
+	}
+
+	double result;
+	if (!mantissa)
+		result = 0;
+	// both operands are exact, so the single rounding of the multiply or divide gives the correctly rounded result
+	else if (!inexact && (mantissa <= (UInt64(1) << 53)) && (exponent >= -22) && (exponent <= 22))
+		result = (exponent < 0) ? double(mantissa) / kPow10[-exponent] : double(mantissa) * kPow10[exponent];
+	else
+		return strtod(str, endPtr);
+
+	if (endPtr)
+		*endPtr = const_cast<char*>(pos);
+	return negative ? -result : result;
+}
@@ -115,6 +115,10 @@ void __fastcall StrToLower(char* str);
 
 char* __fastcall SubStrCI(const char *srcStr, const char *subStr);
 
+// Finds the first occurrence of subStr within the srcLen chars at srcStr, which need not be null-terminated.
+// Case-insensitive compares fold ASCII letters only. An empty subStr matches at srcStr. Returns NULL if not found.
+const char* FindSubStr(const char *srcStr, UInt32 srcLen, const char *subStr, UInt32 subLen, bool caseSensitive);
+
 char* __fastcall SlashPos(const char *str);
 
 char* __fastcall CopyString(const char* key);
@@ -125,6 +129,21 @@ UInt32 __fastcall StrHashCS(const char* inKey);
 
 UInt32 __fastcall StrHashCI(const char* inKey);
 
+// Number to string conversions, both need 32 chars at str and return a pointer to the terminating null.
+// DblToStr gives the same output as "%g"; DblToStrRoundTrip writes the shortest digits that parse back to the same value, laid out like "%.17g".
+char* __fastcall DblToStr(char *str, double num);
+char* __fastcall DblToStrRoundTrip(char *str, double num);
+
+// Used where scripts convert numbers to strings. "%g" unless bRoundTripNumberStrings is set in nvse_config.ini.
+extern bool g_roundTripNumberStrings;
+inline char* NumToStr(char *str, double num) {return g_roundTripNumberStrings ? DblToStrRoundTrip(str, num) : DblToStr(str, num);}
+
+// Same results as strtod. Exact fast path for up to 19 significant digits with small exponents, defers to strtod otherwise.
+double __fastcall StrToDbl(const char *str, char **endPtr = nullptr);
+
+// CRC-32C; uses the SSE4.2 crc32 instruction when available. Pass a previous result as crc to continue it.
+UInt32 __fastcall CRC32C(const void *data, UInt32 length, UInt32 crc = 0);
+
 class SpinLock
 {
 	UInt32	owningThread;